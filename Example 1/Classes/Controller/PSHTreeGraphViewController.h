@@ -14,7 +14,7 @@
 @class PSBaseTreeGraphView;
 
 
-@interface PSHTreeGraphViewController : UIViewController <PSTreeGraphDelegate>
+@interface PSHTreeGraphViewController : UIViewController <PSTreeGraphDelegate, UIScrollViewDelegate>
 
 // The TreeGraph
 @property(nonatomic, weak) IBOutlet PSBaseTreeGraphView *treeGraphView;
@@ -50,6 +50,10 @@
 	// Set the delegate to self.
 	(self.treeGraphView).delegate = self;
 
+	// Keep the TreeGraph informed as it scrolls, so it can prefetch content for nodes about to come
+	// into view, and bring what does come into view up to date.
+	((UIScrollView *)self.treeGraphView.superview).delegate = self;
+
 	// Specify a .nib file for the TreeGraph to load each time it needs to create a new node view.
     (self.treeGraphView).nodeViewNibName = @"ObjCClassTreeNodeView";
 
@@ -76,6 +80,14 @@
 }
 
 
+#pragma mark - Scroll View Delegate
+
+- (void) scrollViewDidScroll:(UIScrollView *)scrollView
+{
+	[self.treeGraphView parentClipViewDidScroll:scrollView];
+}
+
+
 #pragma mark - TreeGraph Delegate
 
 -(void) configureNodeView:(UIView *)nodeView
@@ -100,6 +112,13 @@
 
 }
 
+-(NSString *) labelForModelNode:(id <PSTreeGraphModelNode> )modelNode
+{
+	// Search by class name, the same text shown in the node's title label.  This is called from a
+	// background queue, after the graph has been built, so the subclass caches are already filled in.
+	return ((ObjCClassWrapper *)modelNode).name;
+}
+
 
 #pragma mark - Resouce Management
 
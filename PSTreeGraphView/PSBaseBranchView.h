@@ -28,4 +28,22 @@
 
 @property (weak, nonatomic, readonly) PSBaseTreeGraphView *enclosingTreeGraph;
 
+/// Discards the cached connecting line geometry, and marks the view as needing display.  The
+/// lines are rebuilt, from the frames of the sibling SubtreeViews, at the end of the next layout
+/// (or when the view next draws, if that comes first).
+///
+/// @note Call this when the position of a child SubtreeView, the connecting line style, or the
+/// tree orientation changes.  A change of line color or width only needs -setNeedsDisplay.
+
+- (void) setNeedsConnectionsUpdate;
+
+/// YES if the connecting line geometry has been discarded, and not yet rebuilt.
+
+@property (nonatomic, readonly) BOOL needsConnectionsUpdate;
+
+/// Rebuilds the connecting line geometry, if it needs to be, for the treeGraph's line style and
+/// orientation.
+
+- (void) updateConnectionsForTreeGraph:(PSBaseTreeGraphView *)treeGraph;
+
 @end
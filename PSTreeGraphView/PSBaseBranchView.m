@@ -15,11 +15,38 @@
 #import "PSBaseBranchView.h"
 #import "PSBaseSubtreeView.h"
 #import "PSBaseTreeGraphView.h"
+#import "PSBaseTreeGraphView_Internal.h"
+
+
+#pragma mark - Internal Interface
+
+@interface PSBaseBranchView ()
+{
+
+@private
+
+    // The connecting lines, as pairs of end points in our bounds, ready to be stroked.  Rebuilt
+    // only when a child SubtreeView moves, or the line style or orientation changes.
+    CGPoint *_segmentPoints;
+    size_t _segmentPointCount;
+    size_t _segmentPointCapacity;
+    BOOL _connectionsAreValid;
+}
+
+@end
 
 
 @implementation PSBaseBranchView
 
 
+#pragma mark - Resource Management
+
+- (void) dealloc
+{
+    free(_segmentPoints);
+}
+
+
 - (PSBaseTreeGraphView *) enclosingTreeGraph
 {
     UIView *ancestor = self.superview;
@@ -33,17 +60,46 @@
 }
 
 
-#pragma mark - Drawing (internal)
+#pragma mark - Connection Geometry (internal)
+
+- (void) addSegmentFromPoint:(CGPoint)startPoint toPoint:(CGPoint)endPoint
+{
+    if (_segmentPointCount + 2 > _segmentPointCapacity) {
+        size_t capacity = MAX(_segmentPointCapacity * 2, (size_t)8);
+        CGPoint *segmentPoints = realloc(_segmentPoints, capacity * sizeof(CGPoint));
+        if (segmentPoints == NULL) {
+            return;
+        }
+        _segmentPoints = segmentPoints;
+        _segmentPointCapacity = capacity;
+    }
+
+    _segmentPoints[_segmentPointCount++] = startPoint;
+    _segmentPoints[_segmentPointCount++] = endPoint;
+}
+
+// Returns the point at which the connecting line to a child SubtreeView ends, in our bounds.  The
+// child is our sibling, so this is plain frame arithmetic rather than -convertPoint:fromView:.
+
+static CGPoint targetPointOfSubtreeView(UIView *subview, CGPoint offset, BOOL horizontal)
+{
+    CGRect frame = subview.frame;
+    if ( horizontal ) {
+        return CGPointMake(CGRectGetMinX(frame) - offset.x, CGRectGetMidY(frame) - offset.y);
+    } else {
+        return CGPointMake(CGRectGetMidX(frame) - offset.x, CGRectGetMinY(frame) - offset.y);
+    }
+}
 
-- (UIBezierPath *) directConnectionsPath
+- (void) addDirectConnectionsWithOrientation:(PSTreeGraphOrientationStyle)treeDirection
 {
     CGRect bounds = self.bounds;
 	CGPoint rootPoint = CGPointZero;
 
-	PSTreeGraphOrientationStyle treeDirection = self.enclosingTreeGraph.treeGraphOrientation;
+    BOOL horizontal = (( treeDirection == PSTreeGraphOrientationStyleHorizontal ) ||
+                       ( treeDirection == PSTreeGraphOrientationStyleHorizontalFlipped ));
 
-	if (( treeDirection == PSTreeGraphOrientationStyleHorizontal ) ||
-        ( treeDirection == PSTreeGraphOrientationStyleHorizontalFlipped )){
+	if ( horizontal ) {
 		rootPoint = CGPointMake(CGRectGetMinX(bounds),
                                 CGRectGetMidY(bounds));
 	} else {
@@ -51,59 +107,30 @@
                                 CGRectGetMinY(bounds));
 	}
 
-    // Create a single bezier path that we'll use to stroke all the lines.
-    UIBezierPath *path = [UIBezierPath bezierPath];
+    // Offset from our superview's coordinates to our bounds.
+    CGRect frame = self.frame;
+    CGPoint offset = CGPointMake(CGRectGetMinX(frame) - CGRectGetMinX(bounds),
+                                 CGRectGetMinY(frame) - CGRectGetMinY(bounds));
 
-    // Add a stroke from rootPoint to each child SubtreeView of our containing SubtreeView.
+    // Add a line from rootPoint to each child SubtreeView of our containing SubtreeView.
     UIView *subtreeView = self.superview;
     if ([subtreeView isKindOfClass:[PSBaseSubtreeView class]]) {
 
         for (UIView *subview in subtreeView.subviews) {
             if ([subview isKindOfClass:[PSBaseSubtreeView class]]) {
-                CGRect subviewBounds = subview.bounds;
-				CGPoint targetPoint = CGPointZero;
-
-                if (( treeDirection == PSTreeGraphOrientationStyleHorizontal ) ||
-                    ( treeDirection == PSTreeGraphOrientationStyleHorizontalFlipped )){
-					targetPoint = [self convertPoint:CGPointMake(CGRectGetMinX(subviewBounds), CGRectGetMidY(subviewBounds))
-                                            fromView:subview];
-				} else {
-					targetPoint = [self convertPoint:CGPointMake(CGRectGetMidX(subviewBounds), CGRectGetMinY(subviewBounds))
-                                            fromView:subview];
-				}
-
-                [path moveToPoint:rootPoint];
-                [path addLineToPoint:targetPoint];
+                [self addSegmentFromPoint:rootPoint
+                                  toPoint:targetPointOfSubtreeView(subview, offset, horizontal)];
             }
         }
     }
-
-    // Return the path.
-    return path;
 }
 
-- (UIBezierPath *) orthogonalConnectionsPath
+- (void) addOrthogonalConnectionsWithOrientation:(PSTreeGraphOrientationStyle)treeDirection
 {
-    // Compute the needed adjustment in x and y to align our lines for crisp, exact pixel coverage.
-	// (We can only do this if the lineWidth is integral, which it usually is.)
-	//    CGFloat adjustment = 0.0;
-	//    CGFloat lineWidth = [[self enclosingTreeGraph] connectingLineWidth];
-	//    CGSize lineSize = CGSizeMake(lineWidth, lineWidth);
-	//    CGSize lineSizeInPixels = [self convertSizeToBase:lineSize];
-	//
-	//    CGFloat halfLineWidthInPixels = 0.5 * lineSizeInPixels.width;
-	//    if (fabs(halfLineWidthInPixels - floor(halfLineWidthInPixels)) > 0.0001) {
-	//        // If line width in pixels is odd, lay our path segments along the centers of pixel rows.
-	//        CGSize adjustmentAsSizeInPixels = CGSizeMake(0.5, 0.5);
-	//        CGSize adjustmentAsSize = [self convertSizeFromBase:adjustmentAsSizeInPixels];
-	//
-	//        adjustment = adjustmentAsSize.width;
-	//    }
-
     CGRect bounds = self.bounds;
-	//    CGPoint basePoint;
 
-	PSTreeGraphOrientationStyle treeDirection = self.enclosingTreeGraph.treeGraphOrientation;
+    BOOL horizontal = (( treeDirection == PSTreeGraphOrientationStyleHorizontal ) ||
+                       ( treeDirection == PSTreeGraphOrientationStyleHorizontalFlipped ));
 
 	CGPoint rootPoint = CGPointZero;
 	if ( treeDirection == PSTreeGraphOrientationStyleHorizontal ) {
@@ -123,30 +150,17 @@
                                 CGRectGetMinY(bounds));
 	}
 
-
-    // Align the line to get exact pixel coverage, for sharper rendering.
-	//    basePoint = [self convertPointToBase:rootPoint];
-	//    basePoint.x = round(basePoint.x) + adjustment;
-	//    basePoint.y = round(basePoint.y) + adjustment;
-	//    rootPoint = [self convertPointFromBase:basePoint];
-
-
 	// Compute point (really, we're just interested in the x value) at which line
     // from root node intersects the vertical connecting line.
 
 	CGPoint rootIntersection = CGPointMake(CGRectGetMidX(bounds), CGRectGetMidY(bounds));
 
+    // Offset from our superview's coordinates to our bounds.
+    CGRect frame = self.frame;
+    CGPoint offset = CGPointMake(CGRectGetMinX(frame) - CGRectGetMinX(bounds),
+                                 CGRectGetMinY(frame) - CGRectGetMinY(bounds));
 
-    // Align the line to get exact pixel coverage, for sharper rendering.
-	//    basePoint = [self convertPointToBase:rootIntersection];
-	//    basePoint.x = round(basePoint.x) + adjustment;
-	//    basePoint.y = round(basePoint.y) + adjustment;
-	//    rootIntersection = [self convertPointFromBase:basePoint];
-
-    // Create a single bezier path that we'll use to stroke all the lines.
-    UIBezierPath *path = [UIBezierPath bezierPath];
-
-    // Add a stroke from each child SubtreeView to where we'll put the vertical connecting line.
+    // Add a line from each child SubtreeView to where we'll put the vertical connecting line.
     // And while we're iterating over SubtreeViews, make a note of the minimum and maximum Y we'll
     // want for the endpoints of the vertical connecting line.
 
@@ -164,29 +178,12 @@
             if ([subview isKindOfClass:[PSBaseSubtreeView class]]) {
                 ++subtreeViewCount;
 
-                CGRect subviewBounds = subview.bounds;
-				CGPoint targetPoint = CGPointZero;
-
-                if (( treeDirection == PSTreeGraphOrientationStyleHorizontal ) ||
-                    ( treeDirection == PSTreeGraphOrientationStyleHorizontalFlipped )){
-					targetPoint = [self convertPoint:CGPointMake(CGRectGetMinX(subviewBounds), CGRectGetMidY(subviewBounds))
-                                            fromView:subview];
-				} else {
-					targetPoint = [self convertPoint:CGPointMake(CGRectGetMidX(subviewBounds), CGRectGetMinY(subviewBounds))
-                                            fromView:subview];
-				}
-
-                // Align the line to get exact pixel coverage, for sharper rendering.
-				//                basePoint = [self convertPointToBase:targetPoint];
-				//                basePoint.x = round(basePoint.x) + adjustment;
-				//                basePoint.y = round(basePoint.y) + adjustment;
-				//                targetPoint = [self convertPointFromBase:basePoint];
+				CGPoint targetPoint = targetPointOfSubtreeView(subview, offset, horizontal);
 
                 // TODO: Make clean line joins (test at high values of line thickness to see the problem).
 
-                if (( treeDirection == PSTreeGraphOrientationStyleHorizontal ) ||
-                    ( treeDirection == PSTreeGraphOrientationStyleHorizontalFlipped )){
-					[path moveToPoint:CGPointMake(rootIntersection.x, targetPoint.y)];
+                if ( horizontal ) {
+                    [self addSegmentFromPoint:CGPointMake(rootIntersection.x, targetPoint.y) toPoint:targetPoint];
 
 					if (minY > targetPoint.y) {
 						minY = targetPoint.y;
@@ -195,7 +192,7 @@
 						maxY = targetPoint.y;
 					}
 				} else {
-					[path moveToPoint:CGPointMake(targetPoint.x, rootIntersection.y)];
+                    [self addSegmentFromPoint:CGPointMake(targetPoint.x, rootIntersection.y) toPoint:targetPoint];
 
 					if (minX > targetPoint.x) {
 						minX = targetPoint.x;
@@ -204,67 +201,86 @@
 						maxX = targetPoint.x;
 					}
 				}
-
-                [path addLineToPoint:targetPoint];
-
             }
         }
     }
 
     if (subtreeViewCount) {
-        // Add a stroke from rootPoint to where we'll put the vertical connecting line.
-        [path moveToPoint:rootPoint];
-        [path addLineToPoint:rootIntersection];
-
-        if (( treeDirection == PSTreeGraphOrientationStyleHorizontal ) ||
-            ( treeDirection == PSTreeGraphOrientationStyleHorizontalFlipped )){
-			// Add a stroke for the vertical connecting line.
-			[path moveToPoint:CGPointMake(rootIntersection.x, minY)];
-			[path addLineToPoint:CGPointMake(rootIntersection.x, maxY)];
+        // Add a line from rootPoint to where we'll put the vertical connecting line.
+        [self addSegmentFromPoint:rootPoint toPoint:rootIntersection];
+
+        // Add the vertical connecting line.
+        if ( horizontal ) {
+            [self addSegmentFromPoint:CGPointMake(rootIntersection.x, minY)
+                              toPoint:CGPointMake(rootIntersection.x, maxY)];
 		} else {
-			// Add a stroke for the vertical connecting line.
-			[path moveToPoint:CGPointMake(minX, rootIntersection.y)];
-			[path addLineToPoint:CGPointMake(maxX, rootIntersection.y)];
+            [self addSegmentFromPoint:CGPointMake(minX, rootIntersection.y)
+                              toPoint:CGPointMake(maxX, rootIntersection.y)];
 		}
-
     }
-
-    // Return the path.
-    return path;
 }
 
-
-#pragma mark - UIView
-
-- (void) drawRect:(CGRect)dirtyRect
+- (void) updateConnectionsForTreeGraph:(PSBaseTreeGraphView *)treeGraph
 {
+    if (_connectionsAreValid) {
+        return;
+    }
+
     // Build the set of lines to stroke, according to our enclosingTreeGraph's connectingLineStyle.
-    UIBezierPath *path = nil;
+    _segmentPointCount = 0;
 
-    switch (self.enclosingTreeGraph.connectingLineStyle) {
+    switch (treeGraph.connectingLineStyle) {
         case PSTreeGraphConnectingLineStyleDirect:
         default:
-            path = [self directConnectionsPath];
+            [self addDirectConnectionsWithOrientation:treeGraph.treeGraphOrientation];
             break;
 
         case PSTreeGraphConnectingLineStyleOrthogonal:
-            path = [self orthogonalConnectionsPath];
+            [self addOrthogonalConnectionsWithOrientation:treeGraph.treeGraphOrientation];
             break;
     }
 
-    // Stroke the path with the appropriate color and line width.
+    _connectionsAreValid = YES;
+    [treeGraph noteConnectorPathRebuilt];
+}
+
+
+#pragma mark - Invalidation
+
+- (void) setNeedsConnectionsUpdate
+{
+    _connectionsAreValid = NO;
+    [self setNeedsDisplay];
+}
+
+- (BOOL) needsConnectionsUpdate
+{
+    return !_connectionsAreValid;
+}
+
+
+#pragma mark - UIView
+
+- (void) drawRect:(CGRect)dirtyRect
+{
     PSBaseTreeGraphView *treeGraph = self.enclosingTreeGraph;
 
+    // Make sure the lines are current.  Usually they are, and drawing is just a stroke.
+    [self updateConnectionsForTreeGraph:treeGraph];
+
 	if ( self.opaque ) {
 		// Fill background.
 		[treeGraph.backgroundColor set];
 		UIRectFill(dirtyRect);
 	}
 
-	// Draw lines
-	[treeGraph.connectingLineColor set];
-	path.lineWidth = treeGraph.connectingLineWidth;
-	[path stroke];
+	// Draw lines with the appropriate color and line width.
+    if (_segmentPointCount > 0) {
+        CGContextRef context = UIGraphicsGetCurrentContext();
+        [treeGraph.connectingLineColor setStroke];
+        CGContextSetLineWidth(context, treeGraph.connectingLineWidth);
+        CGContextStrokeLineSegments(context, _segmentPoints, _segmentPointCount);
+    }
 }
 
 
@@ -15,6 +15,7 @@
 #import <UIKit/UIKit.h>
 
 #import "PSTreeGraphModelNode.h"
+#import "PSTreeGraphLayoutCache.h"
 
 
 @class PSBaseTreeGraphView;
@@ -49,7 +50,8 @@
 
 @property (weak, nonatomic, readonly) PSBaseTreeGraphView *enclosingTreeGraph;
 
-// Whether the model node represented by this SubtreeView is a leaf node (one without child nodes).  This
+// Whether this SubtreeView is a leaf (one without child SubtreeViews of its own).  Children reached only
+// through cross-edges to shared nodes drawn elsewhere do not count.  This
 // can be a useful property to bind user interface state to.  In the TreeGraph demo app, for example,
 // we've bound the "isHidden" property of subtree expand/collapse buttons to this, so that expand/collapse
 // buttons will only be shown for non-leaf nodes.
@@ -71,10 +73,20 @@
 
 @property (nonatomic, assign) BOOL needsGraphLayout;
 
+/// Whether this SubtreeView only groups the roots of a forest.  It shows no node or connecting lines
+/// of its own, and lays its children out next to one another with no parent-child spacing.
+
+@property (nonatomic, assign, getter=isForestRoot) BOOL forestRoot;
+
 /// Recursively marks this subtree, and all of its descendants, as needing relayout.
 
 - (void) recursiveSetNeedsGraphLayout;
 
+/// Marks this subtree, and each of its ancestors, as needing relayout.  Sibling subtrees keep their
+/// current layout.  (When the enclosingTreeGraph is flipped, the whole tree is marked instead.)
+
+- (void) setNeedsGraphLayoutIncludingAncestors;
+
 /// Recursively performs graph layout, if this subtree is marked as needing it.
 
 - (CGSize) layoutGraphIfNeeded;
@@ -91,18 +103,66 @@
 
 @property (nonatomic, assign, getter=isExpanded) BOOL expanded;
 
+/// Expands or collapses this subtree.  If recursively is YES, all descendant subtrees are expanded or
+/// collapsed along with it, which is what setting the expanded property does.  If NO, descendant
+/// subtrees keep their own expansion state, so that, for example, expanding the ancestors of a node
+/// reveals that node without expanding everything beside it.
+
+- (void) setExpanded:(BOOL)flag recursively:(BOOL)recursively;
+
 /// Toggles expansion of this subtree.  This can be wired up as the action of a button or other user interface
 /// control.
 
 - (IBAction) toggleExpansion:(id)sender;
 
 
+#pragma mark - Layout Cache
+
+/// Fills in the layout record describing this SubtreeView's current expansion state and layout.  The
+/// record's nodeIdentifier is left for the caller to fill in.
+
+- (void) getLayoutRecord:(PSTreeGraphLayoutRecord *)record;
+
+/// Restores this SubtreeView's expansion state and layout from a cached record, and marks it as
+/// not needing relayout.  Descendant SubtreeViews are not affected.
+
+- (void) applyLayoutRecord:(const PSTreeGraphLayoutRecord *)record;
+
+
 #pragma mark - Invalidation
 
+/// The parts of a SubtreeView that a change to the enclosing TreeGraph's style can invalidate.
+
+typedef NS_OPTIONS(NSUInteger, PSTreeGraphStyleInvalidation) {
+    PSTreeGraphStyleInvalidationConnectorsDisplay = 1 << 0,
+    PSTreeGraphStyleInvalidationConnectorsGeometry = 1 << 1,
+    PSTreeGraphStyleInvalidationSubtreeBorders = 1 << 2,
+    PSTreeGraphStyleInvalidationLayout = 1 << 3,
+};
+
+/// Applies a style invalidation to this subtree in a single pass.  Layout invalidation marks every
+/// SubtreeView as needing layout.  The rest is applied only to SubtreeViews that are visible: those
+/// that intersect visibleRect (in the coordinate space of the view parentOrigin is relative to) and
+/// aren't hidden.  Each subtree that is out of sight is instead marked stale, and added to
+/// staleSubtreeViews, so the invalidation can be applied when it comes into view.  Pass an invalidation
+/// of zero to apply just the stale marks of this subtree and its descendants.
+
+- (void) invalidateStyle:(PSTreeGraphStyleInvalidation)invalidation
+              withOrigin:(CGPoint)parentOrigin
+             visibleRect:(CGRect)visibleRect
+      showsSubtreeFrames:(BOOL)showsSubtreeFrames
+       staleSubtreeViews:(NSHashTable *)staleSubtreeViews;
+
 /// Marks all BranchView instances in this subtree as needing display.
 
 - (void) recursiveSetConnectorsViewsNeedDisplay;
 
+/// Rebuilds the connecting line geometry of each visible BranchView in this subtree whose geometry was
+/// discarded.  Called by the TreeGraph at the end of layout, so the lines are computed once per layout
+/// rather than when they are drawn.  Subtrees that weren't laid out again are skipped.
+
+- (void) updateConnectionsIfNeededForTreeGraph:(PSBaseTreeGraphView *)treeGraph;
+
 /// Marks all SubtreeView debug borders as needing display.
 
 - (void) resursiveSetSubtreeBordersNeedDisplay;
@@ -33,6 +33,19 @@ static CGFloat subtreeBorderWidth(void)
     return 2.0f;
 }
 
+static void storeLayoutRect(float *dst, CGRect rect)
+{
+    dst[0] = rect.origin.x;
+    dst[1] = rect.origin.y;
+    dst[2] = rect.size.width;
+    dst[3] = rect.size.height;
+}
+
+static CGRect loadLayoutRect(const float *src)
+{
+    return CGRectMake(src[0], src[1], src[2], src[3]);
+}
+
 
 #pragma mark - Internal Interface
 
@@ -43,6 +56,9 @@ static CGFloat subtreeBorderWidth(void)
     
     // the view that shows connections from nodeView to its child nodes
     PSBaseBranchView *_connectorsView;
+
+    // style changes not yet applied, because we were out of sight when they were made
+    PSTreeGraphStyleInvalidation _staleStyleInvalidation;
 }
 
 
@@ -55,19 +71,27 @@ static CGFloat subtreeBorderWidth(void)
 #pragma mark - Attributes
 
 - (void) setExpanded:(BOOL)flag
+{
+    [self setExpanded:flag recursively:YES];
+}
+
+- (void) setExpanded:(BOOL)flag recursively:(BOOL)recursively
 {
     if (_expanded != flag) {
 
         // Remember this SubtreeView's new state.
         _expanded = flag;
 
-        // Notify the TreeGraph we need layout.
-        [self.enclosingTreeGraph setNeedsGraphLayout];
+        // Only this subtree and its ancestors need layout.  Marking ourselves before our descendants
+        // lets their own marking stop as soon as it reaches us.
+        [self setNeedsGraphLayoutIncludingAncestors];
 
         // Expand or collapse subtrees recursively.
-        for (UIView *subview in self.subviews) {
-            if ([subview isKindOfClass:[PSBaseSubtreeView class]]) {
-                ((PSBaseSubtreeView *)subview).expanded = _expanded;
+        if (recursively) {
+            for (UIView *subview in self.subviews) {
+                if ([subview isKindOfClass:[PSBaseSubtreeView class]]) {
+                    [(PSBaseSubtreeView *)subview setExpanded:_expanded recursively:YES];
+                }
             }
         }
     }
@@ -75,26 +99,30 @@ static CGFloat subtreeBorderWidth(void)
 
 - (IBAction) toggleExpansion:(id)sender
 {
-	[UIView beginAnimations:@"TreeNodeExpansion" context:nil];
-//    [UIView setAnimationDuration:8.0];
-	[UIView setAnimationBeginsFromCurrentState:YES];
-    [UIView setAnimationCurve:UIViewAnimationCurveEaseOut];
+    PSBaseTreeGraphView *treeGraph = self.enclosingTreeGraph;
 
     self.expanded = !self.expanded;
 
-    [self.enclosingTreeGraph layoutGraphIfNeeded];
+    // Only the nodes that move are animated.  See -[PSBaseTreeGraphView layoutGraphIfNeededAnimated:].
+    [treeGraph layoutGraphIfNeededAnimated:YES];
 
     if ( self.modelNode != nil ) {
         NSSet *visibleSet = [NSSet setWithObject:self.modelNode];
-        [self.enclosingTreeGraph scrollModelNodesToVisible:visibleSet animated:NO];
+        BOOL animated = treeGraph.animatesLayout && !treeGraph.layoutAnimationSuppressed;
+        [treeGraph scrollModelNodesToVisible:visibleSet animated:animated];
     }
-
-    [UIView commitAnimations];
 }
 
 - (BOOL) isLeaf
 {
-    return [self.modelNode childModelNodes].count == 0;
+    // Shared nodes are owned by their first parent, so a node whose children are all drawn
+    // elsewhere (as cross-edges) has nothing to expand or collapse.
+    for (UIView *subview in self.subviews) {
+        if ([subview isKindOfClass:[PSBaseSubtreeView class]]) {
+            return NO;
+        }
+    }
+    return YES;
 }
 
 
@@ -162,6 +190,30 @@ static CGFloat subtreeBorderWidth(void)
     }
 }
 
+- (void) setNeedsGraphLayoutIncludingAncestors
+{
+    PSBaseTreeGraphView *treeGraph = self.enclosingTreeGraph;
+    PSTreeGraphOrientationStyle treeOrientation = treeGraph.treeGraphOrientation;
+
+    if (( treeOrientation == PSTreeGraphOrientationStyleHorizontalFlipped ) ||
+        ( treeOrientation == PSTreeGraphOrientationStyleVerticalFlipped )){
+        // Flipping mirrors the laid out tree in place, starting from the root, so it can only be
+        // redone for the whole tree.
+        if (!treeGraph.needsGraphLayout) {
+            [treeGraph setNeedsGraphLayout];
+        }
+        return;
+    }
+
+    // Any SubtreeView that needs layout has ancestors that need layout too, so we can stop at the
+    // first one that is already marked.
+    UIView *view = self;
+    while ([view isKindOfClass:[PSBaseSubtreeView class]] && !((PSBaseSubtreeView *)view).needsGraphLayout) {
+        ((PSBaseSubtreeView *)view).needsGraphLayout = YES;
+        view = view.superview;
+    }
+}
+
 - (CGSize) sizeNodeViewToFitContent
 {
     // TODO: Node size is hardwired for now, but the layout algorithm could accommodate
@@ -196,6 +248,9 @@ static CGFloat subtreeBorderWidth(void)
             [(PSBaseSubtreeView *)subview flipTreeGraph];
         }
     }
+
+    // Our children have moved.
+    [_connectorsView setNeedsConnectionsUpdate];
 }
 
 - (CGSize) layoutGraphIfNeeded
@@ -225,7 +280,7 @@ static CGFloat subtreeBorderWidth(void)
 
     PSBaseTreeGraphView *treeGraph = self.enclosingTreeGraph;
 
-	CGFloat parentChildSpacing = treeGraph.parentChildSpacing;
+	CGFloat parentChildSpacing = self.forestRoot ? 0.0f : treeGraph.parentChildSpacing;
     CGFloat siblingSpacing = treeGraph.siblingSpacing;
 	PSTreeGraphOrientationStyle treeOrientation = treeGraph.treeGraphOrientation;
 
@@ -394,7 +449,10 @@ static CGFloat subtreeBorderWidth(void)
         // NOTE: Enable this line if a collapse animation is added (line below not used)
         // [_connectorsView setContentMode:UIViewContentModeRedraw];
 
-        [_connectorsView setHidden:NO];
+        // Our children have been laid out again, so the lines to them must be rebuilt.  The roots of
+        // a forest aren't connected to anything.
+        [_connectorsView setNeedsConnectionsUpdate];
+        [_connectorsView setHidden:self.forestRoot];
 
     } else {
         // No SubtreeViews; this is a leaf node.
@@ -484,9 +542,57 @@ static CGFloat subtreeBorderWidth(void)
 }
 
 
+#pragma mark - Layout Cache
+
+- (void) getLayoutRecord:(PSTreeGraphLayoutRecord *)record
+{
+    NSParameterAssert(record != NULL);
+
+    uint32_t flags = 0;
+    if (_expanded) {
+        flags |= PSTreeGraphLayoutRecordFlagExpanded;
+    }
+    if (self.hidden) {
+        flags |= PSTreeGraphLayoutRecordFlagHidden;
+    }
+    if (_connectorsView.hidden) {
+        flags |= PSTreeGraphLayoutRecordFlagConnectorsHidden;
+    }
+    record->flags = flags;
+
+    storeLayoutRect(record->frame, self.frame);
+    storeLayoutRect(record->nodeViewFrame, self.nodeView.frame);
+    storeLayoutRect(record->connectorsFrame, _connectorsView.frame);
+}
+
+- (void) applyLayoutRecord:(const PSTreeGraphLayoutRecord *)record
+{
+    NSParameterAssert(record != NULL);
+
+    // Set the ivar directly.  The expanded setter would recurse into our descendants, and mark the
+    // whole tree as needing layout, which is exactly what restoring from the cache avoids.
+    _expanded = (record->flags & PSTreeGraphLayoutRecordFlagExpanded) ? YES : NO;
+
+    self.hidden = (record->flags & PSTreeGraphLayoutRecordFlagHidden) ? YES : NO;
+    self.frame = loadLayoutRect(record->frame);
+    self.nodeView.frame = loadLayoutRect(record->nodeViewFrame);
+
+    _connectorsView.hidden = (record->flags & PSTreeGraphLayoutRecordFlagConnectorsHidden) ? YES : NO;
+    _connectorsView.frame = loadLayoutRect(record->connectorsFrame);
+    [_connectorsView setNeedsConnectionsUpdate];
+
+    self.needsGraphLayout = NO;
+}
+
+
 #pragma mark - Drawing
 
 - (void) updateSubtreeBorder
+{
+    [self updateSubtreeBorderShowingFrame:self.enclosingTreeGraph.showsSubtreeFrames];
+}
+
+- (void) updateSubtreeBorderShowingFrame:(BOOL)showsSubtreeFrame
 {
     // // Disable implicit animations during these layer property changes, to make them take effect immediately.
     // BOOL actionsWereDisabled = [CATransaction disableActions];
@@ -499,9 +605,7 @@ static CGFloat subtreeBorderWidth(void)
     
     CALayer *layer = self.layer;
 
-    PSBaseTreeGraphView *treeGraph = self.enclosingTreeGraph;
-    
-    if (treeGraph.showsSubtreeFrames) {
+    if (showsSubtreeFrame) {
         layer.borderWidth = subtreeBorderWidth();
         layer.borderColor = subtreeBorderColor().CGColor;
     } else {
@@ -516,6 +620,65 @@ static CGFloat subtreeBorderWidth(void)
 
 #pragma mark - Invalidation
 
+- (void) invalidateStyle:(PSTreeGraphStyleInvalidation)invalidation
+              withOrigin:(CGPoint)parentOrigin
+             visibleRect:(CGRect)visibleRect
+      showsSubtreeFrames:(BOOL)showsSubtreeFrames
+       staleSubtreeViews:(NSHashTable *)staleSubtreeViews
+{
+    BOOL invalidatesLayout = (invalidation & PSTreeGraphStyleInvalidationLayout) ? YES : NO;
+    PSTreeGraphStyleInvalidation displayInvalidation = invalidation & ~PSTreeGraphStyleInvalidationLayout;
+
+    if (invalidatesLayout) {
+        self.needsGraphLayout = YES;
+    }
+
+    CGRect frame = CGRectOffset(self.frame, parentOrigin.x, parentOrigin.y);
+    BOOL visible = !self.hidden && CGRectIntersectsRect(frame, visibleRect);
+
+    if (!visible) {
+        // Out of sight.  Remember what is stale here, for all of this subtree, and catch up when it
+        // comes into view.  Only layout still has to reach our descendants now.
+        if (displayInvalidation) {
+            _staleStyleInvalidation |= displayInvalidation;
+            [staleSubtreeViews addObject:self];
+        }
+        if (!invalidatesLayout) {
+            return;
+        }
+        displayInvalidation = 0;
+    } else {
+        displayInvalidation |= _staleStyleInvalidation;
+        _staleStyleInvalidation = 0;
+
+        if (displayInvalidation & PSTreeGraphStyleInvalidationConnectorsGeometry) {
+            [_connectorsView setNeedsConnectionsUpdate];
+        } else if (displayInvalidation & PSTreeGraphStyleInvalidationConnectorsDisplay) {
+            [_connectorsView setNeedsDisplay];
+        }
+        if (displayInvalidation & PSTreeGraphStyleInvalidationSubtreeBorders) {
+            [self updateSubtreeBorderShowingFrame:showsSubtreeFrames];
+        }
+
+        // Nothing to pass down.  Any stale descendants are tracked on their own.
+        if (displayInvalidation == 0 && !invalidatesLayout) {
+            return;
+        }
+    }
+
+    // Recurse for descendant SubtreeViews.
+    PSTreeGraphStyleInvalidation childInvalidation = displayInvalidation | (invalidation & PSTreeGraphStyleInvalidationLayout);
+    for (UIView *subview in self.subviews) {
+        if ([subview isKindOfClass:[PSBaseSubtreeView class]]) {
+            [(PSBaseSubtreeView *)subview invalidateStyle:childInvalidation
+                                               withOrigin:frame.origin
+                                              visibleRect:visibleRect
+                                       showsSubtreeFrames:showsSubtreeFrames
+                                        staleSubtreeViews:staleSubtreeViews];
+        }
+    }
+}
+
 - (void) recursiveSetConnectorsViewsNeedDisplay
 {
     // Mark this SubtreeView's connectorsView as needing display.
@@ -530,18 +693,45 @@ static CGFloat subtreeBorderWidth(void)
     }
 }
 
+- (void) updateConnectionsIfNeededForTreeGraph:(PSBaseTreeGraphView *)treeGraph
+{
+    // Laying out a subtree lays out its ancestors too, so a subtree whose lines are still valid has
+    // no descendants that were laid out again.
+    if (self.hidden || !_connectorsView.needsConnectionsUpdate) {
+        return;
+    }
+
+    if (!_connectorsView.hidden) {
+        [_connectorsView updateConnectionsForTreeGraph:treeGraph];
+    }
+
+    // Recurse for descendant SubtreeViews.
+    NSArray *subviews = self.subviews;
+    for (UIView *subview in subviews) {
+        if ([subview isKindOfClass:[PSBaseSubtreeView class]]) {
+            [(PSBaseSubtreeView *)subview updateConnectionsIfNeededForTreeGraph:treeGraph];
+        }
+    }
+}
+
 - (void) resursiveSetSubtreeBordersNeedDisplay
 {
     // We only need this if layer-backed.  When we have a backing layer, we use the
     // layer's "border" properties to draw the subtree debug border.
 
-    [self updateSubtreeBorder];
+    // Ask the TreeGraph once, rather than once for every SubtreeView.
+    [self recursiveUpdateSubtreeBordersShowingFrames:self.enclosingTreeGraph.showsSubtreeFrames];
+}
+
+- (void) recursiveUpdateSubtreeBordersShowingFrames:(BOOL)showsSubtreeFrames
+{
+    [self updateSubtreeBorderShowingFrame:showsSubtreeFrames];
 
     // Recurse for descendant SubtreeViews.
     NSArray *subviews = self.subviews;
     for (UIView *subview in subviews) {
         if ([subview isKindOfClass:[PSBaseSubtreeView class]]) {
-            [(PSBaseSubtreeView *)subview updateSubtreeBorder];
+            [(PSBaseSubtreeView *)subview recursiveUpdateSubtreeBordersShowingFrames:showsSubtreeFrames];
         }
     }
 }
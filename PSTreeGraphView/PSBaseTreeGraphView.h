@@ -33,6 +33,19 @@ typedef NS_ENUM(NSUInteger, PSTreeGraphOrientationStyle) {
 };
 
 
+/// Posted after the TreeGraph lays out its nodes, restores a cached layout, replaces its tree, or
+/// resizes to fit its enclosing UIScrollView.  The notification object is the TreeGraph.
+
+extern NSString * const PSTreeGraphViewDidLayoutNotification;
+
+/// A userInfo key of PSTreeGraphViewDidLayoutNotification.  When present, an NSValue holding the
+/// rect, in TreeGraph coordinates, outside of which nothing changed (CGRectNull if nothing did).
+/// When absent, treat the whole TreeGraph as changed.  Only layouts that leave the TreeGraph's size
+/// unchanged report a rect, and only while a PSTreeGraphMinimapView is attached to the TreeGraph.
+
+extern NSString * const PSTreeGraphViewChangedRectKey;
+
+
 
 @class PSBaseSubtreeView;
 
@@ -55,6 +68,11 @@ typedef NS_ENUM(NSUInteger, PSTreeGraphOrientationStyle) {
 
 - (void) parentClipViewDidResize:(id)object;
 
+/// Call this as the enclosing UIScrollView scrolls (from -scrollViewDidScroll:, for example).  It lets the
+/// TreeGraph track which nodes are about to become visible, for delegates that prefetch node content.
+
+- (void) parentClipViewDidScroll:(id)object;
+
 
 #pragma mark - Creating Instances
 
@@ -77,6 +95,17 @@ typedef NS_ENUM(NSUInteger, PSTreeGraphOrientationStyle) {
 
 @property (nonatomic, strong) id <PSTreeGraphModelNode> modelRoot;
 
+/// The roots of a forest to display side by side, for models with more than one top level node.
+/// Setting a single root is the same as setting modelRoot.  With several, modelRoot becomes an
+/// internal node that groups them, which is never drawn or selected.
+///
+/// @note The model may be a directed acyclic graph rather than a tree.  A node reachable from more
+/// than one parent (or root) gets a single SubtreeView, laid out under the first parent that reaches
+/// it, in depth first order.  Each other parent is joined to it by a dashed cross-edge instead, so
+/// memory and layout cost grow with the number of distinct nodes, not the number of paths to them.
+
+@property (nonatomic, copy) NSArray *modelRoots;
+
 
 #pragma mark - Root SubtreeView Access
 
@@ -169,6 +198,18 @@ typedef NS_ENUM(NSUInteger, PSTreeGraphOrientationStyle) {
 
 - (CGSize) layoutGraphIfNeeded;
 
+/// The number of BranchViews that have rebuilt their connecting line geometry since the tree was
+/// last laid out.  The geometry is rebuilt at the end of layout, so read this right after layout.
+/// After an incremental layout it should be no more than the number of subtrees that were laid out
+/// again.  Useful when tuning layout and drawing.
+
+@property (nonatomic, readonly) NSUInteger connectorPathRebuildCount;
+
+/// The number of passes over the tree that have applied recorded style changes.  Style changes made
+/// together, or within -performStyleUpdates:, should add one.  Useful when tuning styling.
+
+@property (nonatomic, readonly) NSUInteger styleUpdatePassCount;
+
 /// Collapses the root node, if it is currently expanded.
 
 - (void) collapseRoot;
@@ -190,6 +231,71 @@ typedef NS_ENUM(NSUInteger, PSTreeGraphOrientationStyle) {
 - (CGRect) boundsOfModelNodes:(NSSet *)modelNodes;
 
 
+#pragma mark - Layout Cache
+
+/// The location of a persistent layout cache for the TreeGraph.  Defaults to nil (no cache).  When set,
+/// assigning a modelRoot restores the expansion state and layout last written to the cache, instead of
+/// laying out the tree from scratch, provided the cache still matches the model and layout metrics.
+/// A cache that does not match is ignored, and the tree is laid out as usual.
+///
+/// @note The cache is only written and read when the model nodes implement -modelNodeIdentifier.  The
+/// view tree is still built in full, and checked against the cache, so only the layout pass is saved.
+/// See PSTreeGraphLayoutCache.
+
+@property (nonatomic, copy) NSURL *layoutCacheURL;
+
+/// Writes the TreeGraph's current expansion state and layout to layoutCacheURL, so that it can be restored
+/// the next time the same modelRoot is displayed.  Call this when the application is about to be suspended,
+/// or when the user is done with the tree.  Returns NO and sets error if the cache could not be written.
+
+- (BOOL) writeLayoutCache:(NSError **)error;
+
+
+#pragma mark - Subtree Rasterization
+
+/// If YES, large subtrees that are visible and haven't changed since the last layout are flattened
+/// into one cached bitmap each (using their layer's shouldRasterize), so scrolling composites one
+/// layer per subtree instead of a layer per node and connecting line.  A subtree is unflattened when
+/// it is laid out again, holds a selected node, or is touched.  Defaults to NO.
+///
+/// @note The set of flattened subtrees is updated from -parentClipViewDidScroll:, so call that as the
+/// enclosing UIScrollView scrolls.
+
+@property (nonatomic, assign) BOOL rasterizesStableSubtrees;
+
+/// Subtrees with a smaller area than this, in points, are never flattened on their own.  Defaults
+/// to 65536 (256 x 256 points).  Subtrees larger than the visible rect are never flattened either,
+/// their children are considered instead.
+
+@property (nonatomic, assign) CGFloat minimumRasterizedSubtreeArea;
+
+/// The most memory, in bytes, that flattened subtree bitmaps may use.  Larger subtrees that would
+/// exceed the budget are split into their children instead.  Defaults to 32 MB.
+///
+/// @note Core Animation also limits its own rasterization cache, and discards bitmaps for layers that
+/// go unused for a while, so this is an upper bound rather than a reservation.
+
+@property (nonatomic, assign) NSUInteger rasterizationCacheBudget;
+
+/// The estimated memory, in bytes, of the bitmaps for the currently flattened subtrees.
+
+@property (nonatomic, readonly) NSUInteger rasterizationCacheSize;
+
+/// The number of subtrees currently flattened.
+
+@property (nonatomic, readonly) NSUInteger rasterizedSubtreeCount;
+
+/// The fraction, from 0 to 1, of the subtrees chosen for flattening after each layout whose bitmap
+/// survived the layout, rather than being rendered anew, since statistics were last reset.  Scrolling
+/// doesn't count, only the choice made after each layout.
+
+@property (nonatomic, readonly) CGFloat rasterizationCacheHitRate;
+
+/// Resets rasterizationCacheHitRate.
+
+- (void) resetRasterizationStatistics;
+
+
 #pragma mark - Scrolling
 
 /// Does a [self scrollRectToVisible:] with the bounding box of the specified model nodes.
@@ -201,6 +307,34 @@ typedef NS_ENUM(NSUInteger, PSTreeGraphOrientationStyle) {
 - (void) scrollSelectedModelNodesToVisibleAnimated:(BOOL)animated;
 
 
+#pragma mark - Searching
+
+/// The text to search node labels for.  Searching requires a delegate that implements -labelForModelNode:.
+/// The TreeGraph indexes the labels on a background queue each time the modelRoot is set, and searches as
+/// soon as the index is ready.  A node matches if its label, or a word in its label, begins with the search
+/// string (ignoring case and diacritics).  Setting this expands any collapsed subtrees hiding the first
+/// match in the tree, scrolls it to visible and selects it, along with any other matches on screen.  Other
+/// matches are selected as they are scrolled into view.  Set to nil to end the search.
+///
+/// Typing into the TreeGraph with a hardware keyboard edits this too: "/" starts a search, Tab moves to
+/// the next match, Return ends typing, and "n" and "N" then step through the matches.
+
+@property (nonatomic, copy) NSString *searchString;
+
+/// The model nodes matching the current searchString, in tree order.  Empty when there is no search.
+/// Gathered on demand, which can be expensive for a short search string in a large tree.
+
+@property (nonatomic, readonly, copy) NSArray *searchMatches;
+
+/// Reveals, selects and scrolls the next match of the current search to visible, wrapping around to the first.
+
+- (IBAction) showNextSearchMatch:(id)sender;
+
+/// Reveals, selects and scrolls the previous match of the current search to visible, wrapping around to the last.
+
+- (IBAction) showPreviousSearchMatch:(id)sender;
+
+
 #pragma mark - Animation Support
 
 /// Whether the TreeGraph animates layout operations.  Defaults to YES.  If set to NO, layout
@@ -213,6 +347,14 @@ typedef NS_ENUM(NSUInteger, PSTreeGraphOrientationStyle) {
 
 @property (nonatomic, assign) BOOL layoutAnimationSuppressed;
 
+/// Performs graph layout, if the tree is marked as needing it, like -layoutGraphIfNeeded.  If animated is
+/// YES, and layout animation is enabled, the views that moved are animated from their old positions to
+/// their new ones.  Only views in the subtrees that were laid out again are considered, and only their
+/// layer positions are animated, so nothing is redrawn while the animation runs.  Connecting lines are
+/// drawn once, in their final place, and faded in as the nodes arrive.
+
+- (CGSize) layoutGraphIfNeededAnimated:(BOOL)animated;
+
 
 #pragma mark - Layout Metrics
 
@@ -254,6 +396,17 @@ typedef NS_ENUM(NSUInteger, PSTreeGraphOrientationStyle) {
 
 @property (nonatomic, assign) BOOL showsSubtreeFrames;
 
+/// Makes several style changes at once.  The styling and layout metric setters don't update the tree
+/// themselves.  Each records what it invalidates, and the TreeGraph applies everything recorded in a
+/// single pass over the tree the next time it lays out.  Changes made within updates are applied as
+/// soon as it returns, however many properties change, with at most one traversal and one relayout.
+/// Calls may be nested.
+///
+/// Only visible SubtreeViews are redisplayed.  Those out of sight are marked stale, and catch up as
+/// they are scrolled into view (see -parentClipViewDidScroll:).
+
+- (void) performStyleUpdates:(void (^)(void))updates;
+
 
 #pragma mark - Input and Navigation
 
@@ -267,8 +420,9 @@ typedef NS_ENUM(NSUInteger, PSTreeGraphOrientationStyle) {
 /// A placeholder view is created to so the default keyboard is not presented to the user.
 /// When a hardware keyboard is attached, touching the TreeGraph makes it first responder
 /// and certain keyboard shortcuts become available for navigation. ie. the space bar
-/// expands and collapses the current selection. The following keys; w, a, s, d, navigate
-/// relative to the graph.
+/// expands and collapses the current selection. The arrow keys, or w, a, s, d, move the selection
+/// to the nearest visible node on screen in that direction.  Option (or shift with w and s) pages up
+/// and down, command up and down arrow jump to the root and the last visible node.
 ///
 /// Custom navigation can be added by assigning a custom UIView to inputView, and linking
 /// it up to some of the actions below.
@@ -276,14 +430,26 @@ typedef NS_ENUM(NSUInteger, PSTreeGraphOrientationStyle) {
 @property (nonatomic, strong) IBOutlet UIView *inputView;
 
 // Model relative navigation
-- (void) moveToSiblingByRelativeIndex:(NSInteger)relativeIndex;
 - (IBAction) moveToParent:(id)sender;
 - (IBAction) moveToNearestChild:(id)sender;
 
 // Graph relative navigation
+//
+// Moves to the nearest visible node in the given direction on screen, whether or not it is related
+// to the current selection.  Uses an index of node positions kept from the last layout, and applies
+// the selection and scrolling once per frame, however quickly the keys repeat.
 - (IBAction) moveUp:(id)sender;
 - (IBAction) moveDown:(id)sender;
 - (IBAction) moveLeft:(id)sender;
 - (IBAction) moveRight:(id)sender;
+- (IBAction) pageUp:(id)sender;
+- (IBAction) pageDown:(id)sender;
+- (IBAction) moveToBeginningOfDocument:(id)sender;
+- (IBAction) moveToEndOfDocument:(id)sender;
+
+/// Moves relativeIndex nodes in the direction later (positive) or earlier (negative) siblings are
+/// laid out.  This is now a graph relative move, so it may reach nodes that aren't siblings.
+- (void) moveToSiblingByRelativeIndex:(NSInteger)relativeIndex
+    __attribute__((deprecated("use the graph relative moves, -moveUp: -moveDown: -moveLeft: and -moveRight:")));
 
 @end
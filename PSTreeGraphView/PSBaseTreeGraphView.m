@@ -14,7 +14,10 @@
 #import "PSBaseTreeGraphView.h"
 #import "PSBaseTreeGraphView_Internal.h"
 #import "PSBaseSubtreeView.h"
+#import "PSBaseBranchView.h"
 #import "PSBaseLeafView.h"
+#import "PSTreeGraphLayoutCache.h"
+#import "PSTreeGraphSearchIndex.h"
 
 #import "PSTreeGraphDelegate.h"
 #import "PSTreeGraphModelNode.h"
@@ -23,6 +26,173 @@
 #import <QuartzCore/QuartzCore.h>
 
 
+NSString * const PSTreeGraphViewDidLayoutNotification = @"PSTreeGraphViewDidLayoutNotification";
+NSString * const PSTreeGraphViewChangedRectKey = @"PSTreeGraphViewChangedRectKey";
+
+static const NSTimeInterval PSTreeGraphLayoutAnimationDuration = 0.25;
+
+// Keyboard navigation scores a candidate node by its distance in the direction of travel, plus this
+// multiple of its distance across it, so a node straight ahead beats a closer one off to the side.
+static const CGFloat PSTreeGraphNavigationCrossAxisWeight = 2.0;
+
+// A node must be at least this much further along the direction of travel to count as a move.
+static const CGFloat PSTreeGraphNavigationMinimumDistance = 1.0;
+
+// Stale subtrees are filed in square cells of this size, so a scroll only looks at those near the
+// visible rect.  A subtree that would cover more than the maximum number of cells is kept aside and
+// checked on every scroll instead; there are only ever a few that large.
+static const CGFloat PSTreeGraphStaleCellSize = 512.0;
+static const NSInteger PSTreeGraphStaleMaximumCells = 64;
+
+
+#pragma mark - Navigation Entry
+
+// The center of a visible nodeView in TreeGraph coordinates, and the position of its model node in
+// the navigation index.
+
+typedef struct PSTreeGraphNavigationEntry {
+    CGPoint center;
+    NSUInteger nodeIndex;
+} PSTreeGraphNavigationEntry;
+
+static int PSTreeGraphCompareNavigationEntriesByX(const void *a, const void *b)
+{
+    CGFloat ax = ((const PSTreeGraphNavigationEntry *)a)->center.x;
+    CGFloat bx = ((const PSTreeGraphNavigationEntry *)b)->center.x;
+    return (ax < bx) ? -1 : ((ax > bx) ? 1 : 0);
+}
+
+static int PSTreeGraphCompareNavigationEntriesByY(const void *a, const void *b)
+{
+    CGFloat ay = ((const PSTreeGraphNavigationEntry *)a)->center.y;
+    CGFloat by = ((const PSTreeGraphNavigationEntry *)b)->center.y;
+    return (ay < by) ? -1 : ((ay > by) ? 1 : 0);
+}
+
+// Returns the index of the entry nearest to "target" along one axis, and to "across" on the other,
+// considering only entries strictly between lowerBound and upperBound along the axis.  The entries
+// must be sorted along that axis.  Returns NSNotFound if there is no such entry.
+//
+// Scans outward from target in both directions.  A candidate's score is never less than its distance
+// along the axis, so each scan stops as soon as that distance alone can't beat the best so far.
+
+static NSUInteger PSTreeGraphNearestNavigationEntry(const PSTreeGraphNavigationEntry *entries, NSUInteger count,
+                                                    BOOL alongY, CGFloat target, CGFloat across,
+                                                    CGFloat lowerBound, CGFloat upperBound)
+{
+    NSUInteger low = 0;
+    NSUInteger high = count;
+    while (low < high) {
+        NSUInteger mid = low + (high - low) / 2;
+        CGFloat along = alongY ? entries[mid].center.y : entries[mid].center.x;
+        if (along < target) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    NSUInteger best = NSNotFound;
+    CGFloat bestScore = CGFLOAT_MAX;
+
+    for (NSUInteger i = low; i < count; ++i) {
+        CGFloat along = alongY ? entries[i].center.y : entries[i].center.x;
+        CGFloat distance = along - target;
+        if (distance >= bestScore || along >= upperBound) {
+            break;
+        }
+        if (along > lowerBound) {
+            CGFloat offset = (alongY ? entries[i].center.x : entries[i].center.y) - across;
+            CGFloat score = distance + PSTreeGraphNavigationCrossAxisWeight * fabs(offset);
+            if (score < bestScore) {
+                bestScore = score;
+                best = i;
+            }
+        }
+    }
+
+    for (NSUInteger i = low; i > 0; --i) {
+        CGFloat along = alongY ? entries[i - 1].center.y : entries[i - 1].center.x;
+        CGFloat distance = target - along;
+        if (distance >= bestScore || along <= lowerBound) {
+            break;
+        }
+        if (along < upperBound) {
+            CGFloat offset = (alongY ? entries[i - 1].center.x : entries[i - 1].center.y) - across;
+            CGFloat score = distance + PSTreeGraphNavigationCrossAxisWeight * fabs(offset);
+            if (score < bestScore) {
+                bestScore = score;
+                best = i - 1;
+            }
+        }
+    }
+
+    return best;
+}
+
+
+#pragma mark - Forest Node
+
+// Groups the roots of a forest under a single modelRoot, so the rest of TreeGraph can go on treating
+// what it shows as one tree.  Its SubtreeView is a forest root: it is never drawn or selected.
+
+@interface PSTreeGraphForestNode : NSObject <PSTreeGraphModelNode, NSCopying>
+
+- (instancetype) initWithRootModelNodes:(NSArray *)rootModelNodes;
+
+@end
+
+@implementation PSTreeGraphForestNode
+{
+    NSArray *_rootModelNodes;
+}
+
+- (instancetype) initWithRootModelNodes:(NSArray *)rootModelNodes
+{
+    self = [super init];
+    if (self) {
+        _rootModelNodes = [rootModelNodes copy];
+    }
+    return self;
+}
+
+- (id) copyWithZone:(NSZone *)zone
+{
+    // Immutable.  (Model nodes are used as keys in the ModelNode -> SubtreeView map.)
+    return self;
+}
+
+- (id <PSTreeGraphModelNode> ) parentModelNode
+{
+    return nil;
+}
+
+- (NSArray *) childModelNodes
+{
+    return _rootModelNodes;
+}
+
+- (NSString *) modelNodeIdentifier
+{
+    // Stable across launches, so a forest's layout can be cached like a tree's.  A forest is only
+    // identifiable when every one of its roots is.
+    NSMutableArray *identifiers = [NSMutableArray arrayWithCapacity:_rootModelNodes.count];
+    for (id <PSTreeGraphModelNode> rootModelNode in _rootModelNodes) {
+        if (![rootModelNode respondsToSelector:@selector(modelNodeIdentifier)]) {
+            return nil;
+        }
+        NSString *identifier = [rootModelNode modelNodeIdentifier];
+        if ( identifier == nil ) {
+            return nil;
+        }
+        [identifiers addObject:identifier];
+    }
+    return [identifiers componentsJoinedByString:@"\n"];
+}
+
+@end
+
+
 #pragma mark - Internal Interface
 
 @interface PSBaseTreeGraphView () 
@@ -38,6 +208,61 @@
     
 	// iOS 4 and above ONLY
     UINib *_cachedNodeViewNib;
+
+    // Searching
+    PSTreeGraphSearchIndex *_searchIndex;
+    NSString *_searchKey;
+    NSRange _searchRange;
+    NSArray *_searchMatches;
+    NSUInteger _searchMatchTreeOrder;
+    NSUInteger _searchIndexGeneration;
+    BOOL _typingSearchString;
+
+    // Content Prefetching
+    NSMutableSet *_placeholderModelNodes;
+    NSMutableSet *_prefetchingModelNodes;
+    CGRect _lastVisibleRect;
+
+    // Drawing Statistics
+    NSUInteger _connectorPathRebuildCount;
+    NSUInteger _styleUpdatePassCount;
+
+    // Shared Nodes: (parent, child) pairs that aren't laid out as parent and child.
+    NSMutableArray *_crossEdges;
+    CAShapeLayer *_crossEdgeLayer;
+
+    // Keyboard Navigation: visible nodes in tree order, and their centers sorted along each axis.
+    NSMutableArray *_navigationModelNodes;
+    PSTreeGraphNavigationEntry *_navigationEntriesByX;
+    PSTreeGraphNavigationEntry *_navigationEntriesByY;
+    NSUInteger _navigationEntryCount;
+    BOOL _navigationIndexIsValid;
+
+    // Keyboard Navigation: moves made since the last frame, applied together.
+    id <PSTreeGraphModelNode> _pendingNavigationModelNode;
+    NSUInteger _pendingNavigationMoveCount;
+    CADisplayLink *_navigationDisplayLink;
+
+    // Style Updates
+    PSTreeGraphStyleInvalidation _pendingStyleInvalidation;
+    NSUInteger _styleUpdateNesting;
+    NSHashTable *_staleSubtreeViews;
+
+    // Stale Subtree Lookup
+    NSMutableDictionary *_staleSubtreeViewsByCell;
+    NSMutableArray *_largeStaleSubtreeViews;
+    NSMapTable *_staleSubtreeRects;
+    BOOL _staleSubtreeLookupIsValid;
+
+    // Subtree Rasterization
+    NSHashTable *_rasterizedSubtreeViews;
+    NSHashTable *_interactedSubtreeViews;
+    NSUInteger _rasterizationCacheLookups;
+    NSUInteger _rasterizationCacheHits;
+    BOOL _countsRasterizationLookups;
+
+    // Layout Observation
+    NSUInteger _changedRectReportingCount;
     
 }
 
@@ -60,7 +285,7 @@
 {
     if (_connectingLineColor != newConnectingLineColor) {
         _connectingLineColor = newConnectingLineColor;
-        [self.rootSubtreeView recursiveSetConnectorsViewsNeedDisplay];
+        [self setNeedsStyleUpdate:PSTreeGraphStyleInvalidationConnectorsDisplay];
     }
 }
 
@@ -68,7 +293,7 @@
 {
     if (_contentMargin != newContentMargin) {
         _contentMargin = newContentMargin;
-        [self setNeedsGraphLayout];
+        [self setNeedsStyleUpdate:PSTreeGraphStyleInvalidationLayout];
     }
 }
 
@@ -76,7 +301,7 @@
 {
     if (_parentChildSpacing != newParentChildSpacing) {
         _parentChildSpacing = newParentChildSpacing;
-        [self setNeedsGraphLayout];
+        [self setNeedsStyleUpdate:PSTreeGraphStyleInvalidationLayout];
     }
 }
 
@@ -84,7 +309,7 @@
 {
     if (_siblingSpacing != newSiblingSpacing) {
         _siblingSpacing = newSiblingSpacing;
-        [self setNeedsGraphLayout];
+        [self setNeedsStyleUpdate:PSTreeGraphStyleInvalidationLayout];
     }
 }
 
@@ -92,7 +317,7 @@
 {
     if (_treeGraphOrientation != newTreeGraphOrientation) {
         _treeGraphOrientation = newTreeGraphOrientation;
-        [self.rootSubtreeView recursiveSetConnectorsViewsNeedDisplay];
+        [self setNeedsStyleUpdate:PSTreeGraphStyleInvalidationConnectorsGeometry];
     }
 }
 
@@ -100,7 +325,7 @@
 {
     if (_treeGraphFlipped != newTreeGraphFlipped) {
         _treeGraphFlipped = newTreeGraphFlipped;
-        [self.rootSubtreeView recursiveSetConnectorsViewsNeedDisplay];
+        [self setNeedsStyleUpdate:PSTreeGraphStyleInvalidationConnectorsGeometry];
     }
 }
 
@@ -108,14 +333,14 @@
 {
     if (_connectingLineStyle != newConnectingLineStyle) {
         _connectingLineStyle = newConnectingLineStyle;
-        [self.rootSubtreeView recursiveSetConnectorsViewsNeedDisplay];
+        [self setNeedsStyleUpdate:PSTreeGraphStyleInvalidationConnectorsGeometry];
     }
 }
 
 - (void) setConnectingLineWidth:(CGFloat)newConnectingLineWidth {
     if (_connectingLineWidth != newConnectingLineWidth) {
         _connectingLineWidth = newConnectingLineWidth;
-        [self.rootSubtreeView recursiveSetConnectorsViewsNeedDisplay];
+        [self setNeedsStyleUpdate:PSTreeGraphStyleInvalidationConnectorsDisplay];
     }
 }
 
@@ -125,14 +350,240 @@
         _resizesToFillEnclosingScrollView = flag;
         [self updateFrameSizeForContentAndClipView];
         [self updateRootSubtreeViewPositionForSize:self.rootSubtreeView.frame.size];
+
+        // Every node has moved with the root.
+        [self invalidateNavigationIndex];
+    }
+}
+
+- (void) setNeedsStyleUpdate:(PSTreeGraphStyleInvalidation)invalidation
+{
+    // Coalesce.  Everything recorded is applied together, by -updateStyleIfNeeded.
+    _pendingStyleInvalidation |= invalidation;
+    if (_styleUpdateNesting == 0) {
+        [self setNeedsLayout];
+    }
+}
+
+- (void) performStyleUpdates:(void (^)(void))updates
+{
+    ++_styleUpdateNesting;
+    if (updates) {
+        updates();
+    }
+    --_styleUpdateNesting;
+
+    if (_styleUpdateNesting == 0) {
+        [self updateStyleIfNeeded];
+    }
+}
+
+- (void) updateStyleIfNeeded
+{
+    PSTreeGraphStyleInvalidation invalidation = _pendingStyleInvalidation;
+    if ( invalidation == 0 || _styleUpdateNesting > 0 ) {
+        return;
+    }
+    _pendingStyleInvalidation = 0;
+    ++_styleUpdatePassCount;
+
+    PSBaseSubtreeView *rootSubtreeView = self.rootSubtreeView;
+    if (rootSubtreeView) {
+        NSHashTable *newlyStaleSubtreeViews = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
+        [rootSubtreeView invalidateStyle:invalidation
+                              withOrigin:CGPointZero
+                             visibleRect:[self visibleGraphRect]
+                      showsSubtreeFrames:self.showsSubtreeFrames
+                       staleSubtreeViews:newlyStaleSubtreeViews];
+        [self addStaleSubtreeViews:newlyStaleSubtreeViews];
+    }
+
+    if (invalidation & (PSTreeGraphStyleInvalidationConnectorsDisplay | PSTreeGraphStyleInvalidationConnectorsGeometry)) {
+        [self updateCrossEdges];
+    }
+
+    if (invalidation & PSTreeGraphStyleInvalidationLayout) {
+        [self setNeedsLayout];
+    }
+}
+
+- (BOOL) subtreeViewIsShown:(UIView *)view
+{
+    while (view && view != self) {
+        if (view.hidden) {
+            return NO;
+        }
+        view = view.superview;
+    }
+    return (view == self);
+}
+
+- (void) updateStaleSubtreesInVisibleRect
+{
+    if (_staleSubtreeViews.count == 0) {
+        return;
+    }
+    [self updateStaleSubtreeLookupIfNeeded];
+
+    // Catch up any stale subtrees that have come into view.  Those still out of sight stay stale.
+    // Only the subtrees filed in the cells under the visible rect, and the few large ones, are looked at.
+    CGRect visibleRect = [self visibleGraphRect];
+    BOOL showsSubtreeFrames = self.showsSubtreeFrames;
+
+    if ( CGRectIsNull(visibleRect) ) {
+        return;
+    }
+
+    NSHashTable *candidates = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
+    if ( [self staleRectNeedsManyCells:visibleRect] ) {
+        // Showing most of the graph.  Looking at every cell would cost more than looking at every subtree.
+        for (PSBaseSubtreeView *subtreeView in _staleSubtreeRects) {
+            [candidates addObject:subtreeView];
+        }
+    } else {
+        [self enumerateStaleCellsInRect:visibleRect usingBlock:^(NSNumber *cellKey) {
+            for (PSBaseSubtreeView *subtreeView in _staleSubtreeViewsByCell[cellKey]) {
+                [candidates addObject:subtreeView];
+            }
+        }];
+        for (PSBaseSubtreeView *subtreeView in _largeStaleSubtreeViews) {
+            [candidates addObject:subtreeView];
+        }
+    }
+
+    for (PSBaseSubtreeView *subtreeView in candidates) {
+        CGRect frame = [[_staleSubtreeRects objectForKey:subtreeView] CGRectValue];
+        if ( !CGRectIntersectsRect(frame, visibleRect) ) {
+            continue;
+        }
+
+        [self unfileStaleSubtreeView:subtreeView];
+        [_staleSubtreeViews removeObject:subtreeView];
+
+        CGPoint parentOrigin = CGPointMake(CGRectGetMinX(frame) - CGRectGetMinX(subtreeView.frame),
+                                           CGRectGetMinY(frame) - CGRectGetMinY(subtreeView.frame));
+        NSHashTable *newlyStaleSubtreeViews = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
+        [subtreeView invalidateStyle:0
+                          withOrigin:parentOrigin
+                         visibleRect:visibleRect
+                  showsSubtreeFrames:showsSubtreeFrames
+                   staleSubtreeViews:newlyStaleSubtreeViews];
+        [self addStaleSubtreeViews:newlyStaleSubtreeViews];
     }
 }
 
+
 - (void) setShowsSubtreeFrames:(BOOL)newShowsSubtreeFrames
 {   // DEBUG
     if (_showsSubtreeFrames != newShowsSubtreeFrames) {
         _showsSubtreeFrames = newShowsSubtreeFrames;
-        [self.rootSubtreeView resursiveSetSubtreeBordersNeedDisplay];
+        [self setNeedsStyleUpdate:PSTreeGraphStyleInvalidationSubtreeBorders];
+    }
+}
+
+#pragma mark - Stale Subtree Lookup
+
+- (void) enumerateStaleCellsInRect:(CGRect)rect usingBlock:(void (^)(NSNumber *cellKey))block
+{
+    NSInteger minColumn = (NSInteger)floor(CGRectGetMinX(rect) / PSTreeGraphStaleCellSize);
+    NSInteger maxColumn = (NSInteger)floor(CGRectGetMaxX(rect) / PSTreeGraphStaleCellSize);
+    NSInteger minRow = (NSInteger)floor(CGRectGetMinY(rect) / PSTreeGraphStaleCellSize);
+    NSInteger maxRow = (NSInteger)floor(CGRectGetMaxY(rect) / PSTreeGraphStaleCellSize);
+
+    for (NSInteger row = minRow; row <= maxRow; ++row) {
+        for (NSInteger column = minColumn; column <= maxColumn; ++column) {
+            block(@(((int64_t)row << 32) | (uint32_t)column));
+        }
+    }
+}
+
+- (BOOL) staleRectNeedsManyCells:(CGRect)rect
+{
+    CGFloat columns = floor(CGRectGetMaxX(rect) / PSTreeGraphStaleCellSize) - floor(CGRectGetMinX(rect) / PSTreeGraphStaleCellSize) + 1.0;
+    CGFloat rows = floor(CGRectGetMaxY(rect) / PSTreeGraphStaleCellSize) - floor(CGRectGetMinY(rect) / PSTreeGraphStaleCellSize) + 1.0;
+    return (columns * rows > PSTreeGraphStaleMaximumCells);
+}
+
+- (void) fileStaleSubtreeView:(PSBaseSubtreeView *)subtreeView
+{
+    // A hidden subtree can only be shown by a layout, which refiles everything.
+    if ( ![self subtreeViewIsShown:subtreeView] ) {
+        return;
+    }
+
+    CGRect frame = [self convertRect:subtreeView.bounds fromView:subtreeView];
+    [_staleSubtreeRects setObject:[NSValue valueWithCGRect:frame] forKey:subtreeView];
+
+    if ( [self staleRectNeedsManyCells:frame] ) {
+        [_largeStaleSubtreeViews addObject:subtreeView];
+        return;
+    }
+
+    [self enumerateStaleCellsInRect:frame usingBlock:^(NSNumber *cellKey) {
+        NSMutableArray *cell = _staleSubtreeViewsByCell[cellKey];
+        if (cell == nil) {
+            cell = [[NSMutableArray alloc] init];
+            _staleSubtreeViewsByCell[cellKey] = cell;
+        }
+        [cell addObject:subtreeView];
+    }];
+}
+
+- (void) unfileStaleSubtreeView:(PSBaseSubtreeView *)subtreeView
+{
+    NSValue *frameValue = [_staleSubtreeRects objectForKey:subtreeView];
+    if (frameValue == nil) {
+        return;
+    }
+    [_staleSubtreeRects removeObjectForKey:subtreeView];
+
+    CGRect frame = [frameValue CGRectValue];
+    if ( [self staleRectNeedsManyCells:frame] ) {
+        [_largeStaleSubtreeViews removeObjectIdenticalTo:subtreeView];
+        return;
+    }
+
+    [self enumerateStaleCellsInRect:frame usingBlock:^(NSNumber *cellKey) {
+        NSMutableArray *cell = _staleSubtreeViewsByCell[cellKey];
+        [cell removeObjectIdenticalTo:subtreeView];
+        if (cell.count == 0) {
+            [_staleSubtreeViewsByCell removeObjectForKey:cellKey];
+        }
+    }];
+}
+
+- (void) invalidateStaleSubtreeLookup
+{
+    // Frames have moved.  Everything is refiled on the next scroll that needs it.
+    _staleSubtreeLookupIsValid = NO;
+}
+
+- (void) updateStaleSubtreeLookupIfNeeded
+{
+    if (_staleSubtreeLookupIsValid) {
+        return;
+    }
+
+    [_staleSubtreeViewsByCell removeAllObjects];
+    [_largeStaleSubtreeViews removeAllObjects];
+    [_staleSubtreeRects removeAllObjects];
+    for (PSBaseSubtreeView *subtreeView in _staleSubtreeViews) {
+        [self fileStaleSubtreeView:subtreeView];
+    }
+    _staleSubtreeLookupIsValid = YES;
+}
+
+- (void) addStaleSubtreeViews:(NSHashTable *)subtreeViews
+{
+    // File each newly stale subtree by where it is now, so later scrolls don't have to look it up.
+    for (PSBaseSubtreeView *subtreeView in subtreeViews) {
+        if ( [_staleSubtreeViews containsObject:subtreeView] ) {
+            continue;
+        }
+        [_staleSubtreeViews addObject:subtreeView];
+        if (_staleSubtreeLookupIsValid) {
+            [self fileStaleSubtreeView:subtreeView];
+        }
     }
 }
 
@@ -165,6 +616,23 @@
 	_minimumFrameSize = CGSizeMake(2.0 * _contentMargin, 2.0 * _contentMargin);
 	_selectedModelNodes = [[NSMutableSet alloc] init];
     _modelNodeToSubtreeViewMapTable = [NSMutableDictionary dictionaryWithCapacity:10];
+    _searchMatches = @[];
+    _searchMatchTreeOrder = NSNotFound;
+    _placeholderModelNodes = [[NSMutableSet alloc] init];
+    _prefetchingModelNodes = [[NSMutableSet alloc] init];
+    _lastVisibleRect = CGRectNull;
+    _rasterizesStableSubtrees = NO;
+    _minimumRasterizedSubtreeArea = 256.0 * 256.0;
+    _rasterizationCacheBudget = 32 * 1024 * 1024;
+    _staleSubtreeViews = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
+    _staleSubtreeViewsByCell = [[NSMutableDictionary alloc] init];
+    _largeStaleSubtreeViews = [[NSMutableArray alloc] init];
+    _staleSubtreeRects = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsObjectPointerPersonality
+                                               valueOptions:NSPointerFunctionsStrongMemory];
+    _crossEdges = [[NSMutableArray alloc] init];
+    _navigationModelNodes = [[NSMutableArray alloc] init];
+    _rasterizedSubtreeViews = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
+    _interactedSubtreeViews = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
 
     // If this has been configured by the XIB, leave it during initialization.
     if (_inputView == nil) {
@@ -178,6 +646,9 @@
 - (void) dealloc
 {
     self.delegate = nil;
+
+    free(_navigationEntriesByX);
+    free(_navigationEntriesByY);
 }
 
 
@@ -193,6 +664,31 @@
 }
 
 
+#pragma mark - Delegate
+
+- (void) setDelegate:(id <PSTreeGraphDelegate> )newDelegate
+{
+    if (_delegate != newDelegate) {
+        _delegate = newDelegate;
+
+        // The new delegate may label nodes differently, or not at all.
+        [self buildSearchIndex];
+
+        // The new delegate hasn't been asked to prefetch anything.  If it doesn't prefetch at all,
+        // nothing else will replace the placeholder content, so configure those nodes now.
+        [_prefetchingModelNodes removeAllObjects];
+        _lastVisibleRect = CGRectNull;
+        if ( [self prefetchesNodeContent] ) {
+            [self updateContentPrefetching];
+        } else if ( _placeholderModelNodes.count > 0 ) {
+            NSArray *placeholderModelNodes = [_placeholderModelNodes allObjects];
+            [_placeholderModelNodes removeAllObjects];
+            [self configureNodeViewsForModelNodes:placeholderModelNodes];
+        }
+    }
+}
+
+
 #pragma mark - Root SubtreeView Access
 
 - (PSBaseSubtreeView *) rootSubtreeView
@@ -287,6 +783,9 @@
             }
         }
 
+        // Selected subtrees are no longer stable.
+        [self updateRasterizedSubtrees];
+
         // Release the temporary sets we created.
     }
 }
@@ -310,7 +809,19 @@
     NSParameterAssert(modelNode);
 
     PSBaseSubtreeView *subtreeView = [[PSBaseSubtreeView alloc] initWithModelNode:modelNode];
-    if (subtreeView) {
+    if (subtreeView && [modelNode isKindOfClass:[PSTreeGraphForestNode class]]) {
+
+        // A forest root has an empty nodeView, and nothing for the delegate to configure.
+        UIView *nodeView = [[UIView alloc] initWithFrame:CGRectZero];
+        nodeView.hidden = YES;
+        subtreeView.nodeView = nodeView;
+        subtreeView.forestRoot = YES;
+
+        [subtreeView addSubview:nodeView];
+        [self setSubtreeView:subtreeView forModelNode:modelNode];
+        [self addChildSubtreeViewsOfModelNode:modelNode toSubtreeView:subtreeView];
+
+    } else if (subtreeView) {
 
         // Get nib from which to load nodeView.
         UINib *nodeViewNib = self.cachedNodeViewNib;
@@ -333,8 +844,15 @@
 
 		if ( nibViews ) {
 
-			// Ask our delete to configure the interface for the modelNode displayed in nodeView.
-			if ( [self.delegate conformsToProtocol:@protocol(PSTreeGraphDelegate)] ) {
+			// Ask our delete to configure the interface for the modelNode displayed in nodeView.  A delegate
+			// that prefetches only provides placeholder content for now.  The real content is configured once
+			// the node is about to be seen.
+			if ( [self prefetchesNodeContent] ) {
+				if ( [self.delegate respondsToSelector:@selector(configurePlaceholderNodeView:withModelNode:)] ) {
+					[self.delegate configurePlaceholderNodeView:subtreeView.nodeView withModelNode:modelNode];
+				}
+				[_placeholderModelNodes addObject:modelNode];
+			} else if ( [self.delegate conformsToProtocol:@protocol(PSTreeGraphDelegate)] ) {
 				[self.delegate configureNodeView:subtreeView.nodeView withModelNode:modelNode ];
 			}
 
@@ -345,23 +863,7 @@
             [self setSubtreeView:subtreeView forModelNode:modelNode];
 
             // Recurse to create a SubtreeView for each descendant of modelNode.
-            NSArray *childModelNodes = [modelNode childModelNodes];
-
-            NSAssert(childModelNodes != nil,
-                     @"childModelNodes should return an empty array ([NSArray array]), not nil.");
-
-            if (childModelNodes != nil) {
-                for (id <PSTreeGraphModelNode> childModelNode in childModelNodes) {
-                    PSBaseSubtreeView *childSubtreeView = [self newGraphForModelNode:childModelNode];
-                    if (childSubtreeView != nil) {
-
-                        // Add the child subtreeView behind the parent subtreeView's nodeView (so that when we
-                        // collapse the subtree, its nodeView will remain frontmost).
-
-                        [subtreeView insertSubview:childSubtreeView belowSubview:subtreeView.nodeView];
-                    }
-                }
-            }
+            [self addChildSubtreeViewsOfModelNode:modelNode toSubtreeView:subtreeView];
 
         } else {
             subtreeView = nil;
@@ -371,6 +873,35 @@
     return subtreeView;
 }
 
+- (void) addChildSubtreeViewsOfModelNode:(id <PSTreeGraphModelNode> )modelNode
+                           toSubtreeView:(PSBaseSubtreeView *)subtreeView
+{
+    NSArray *childModelNodes = [modelNode childModelNodes];
+
+    NSAssert(childModelNodes != nil,
+             @"childModelNodes should return an empty array ([NSArray array]), not nil.");
+
+    for (id <PSTreeGraphModelNode> childModelNode in childModelNodes) {
+
+        // A node we have already reached through another parent keeps the SubtreeView it has.  Join
+        // this parent to it with a cross-edge, rather than building (and laying out) it all again.
+        // This also stops a cycle in the model from recursing forever.
+        if ([self subtreeViewForModelNode:childModelNode] != nil) {
+            [_crossEdges addObject:@[ modelNode, childModelNode ]];
+            continue;
+        }
+
+        PSBaseSubtreeView *childSubtreeView = [self newGraphForModelNode:childModelNode];
+        if (childSubtreeView != nil) {
+
+            // Add the child subtreeView behind the parent subtreeView's nodeView (so that when we
+            // collapse the subtree, its nodeView will remain frontmost).
+
+            [subtreeView insertSubview:childSubtreeView belowSubview:subtreeView.nodeView];
+        }
+    }
+}
+
 - (void) buildGraph
 {
     @autoreleasepool {
@@ -446,6 +977,9 @@
 
     // [(animateLayout ? [rootSubtreeView animator] : rootSubtreeView) setFrameOrigin:newOrigin];
 
+    // Every subtree is positioned through here, so the filed stale rects are out of date.
+    [self invalidateStaleSubtreeLookup];
+
 	rootSubtreeView.frame = CGRectMake(newOrigin.x,
 									   newOrigin.y,
 									   rootSubtreeView.frame.size.width,
@@ -461,40 +995,106 @@
         [self updateFrameSizeForContentAndClipView];
         [self updateRootSubtreeViewPositionForSize:self.rootSubtreeView.frame.size];
         [self scrollSelectedModelNodesToVisibleAnimated:NO];
+        [self updateStaleSubtreesInVisibleRect];
+        [self updateContentPrefetching];
+        [self updateRasterizedSubtrees];
+
+        [self invalidateNavigationIndex];
+        [[NSNotificationCenter defaultCenter] postNotificationName:PSTreeGraphViewDidLayoutNotification object:self];
     }
 }
 
+- (void) parentClipViewDidScroll:(id)object
+{
+    [self updateVisibleSearchMatches];
+    [self updateStaleSubtreesInVisibleRect];
+    [self updateContentPrefetching];
+    [self updateRasterizedSubtrees];
+}
+
 - (void) layoutSubviews
 {
-    // Do graph layout if we need to.
+    // Apply any style changes, then do graph layout if we need to.
+    [self updateStyleIfNeeded];
     [self layoutGraphIfNeeded];
 }
 
+- (void) updateFrameForRootSubtreeViewSize:(CGSize)rootSubtreeViewSize
+{
+    // Compute self's new minimumFrameSize.  Make sure it's pixel-integral.
+    CGFloat margin = self.contentMargin;
+    CGSize minimumBoundsSize = CGSizeMake(rootSubtreeViewSize.width + 2.0 * margin,
+                                          rootSubtreeViewSize.height + 2.0 * margin);
+
+	_minimumFrameSize = minimumBoundsSize;
+
+    // Set the TreeGraph's frame size.
+    [self updateFrameSizeForContentAndClipView];
+
+    // Position the TreeGraph's root SubtreeView.
+    [self updateRootSubtreeViewPositionForSize:rootSubtreeViewSize];
+}
+
 - (CGSize) layoutGraphIfNeeded
 {
+    return [self layoutGraphIfNeededWithPreviousFrames:nil];
+}
+
+- (CGSize) layoutGraphIfNeededWithPreviousFrames:(NSMapTable *)previousFrames
+{
+    // Style changes may call for layout.
+    [self updateStyleIfNeeded];
+
     PSBaseSubtreeView *rootSubtreeView = self.rootSubtreeView;
     if ([self needsGraphLayout] && self.modelRoot) {
 
-        // Do recursive graph layout, starting at our rootSubtreeView.
-        CGSize rootSubtreeViewSize = [rootSubtreeView layoutGraphIfNeeded];
+        // Count connecting line rebuilds afresh for each layout.
+        _connectorPathRebuildCount = 0;
 
-        // Compute self's new minimumFrameSize.  Make sure it's pixel-integral.
-        CGFloat margin = self.contentMargin;
-        CGSize minimumBoundsSize = CGSizeMake(rootSubtreeViewSize.width + 2.0 * margin,
-                                              rootSubtreeViewSize.height + 2.0 * margin);
+        // Observers are only told what changed if one of them asked.  The animated path has already
+        // recorded the frames, otherwise record them here, but only when they will be used.
+        CGSize previousSize = self.bounds.size;
+        if ( previousFrames == nil && _changedRectReportingCount > 0 ) {
+            previousFrames = [self framesForLayoutOfRootSubtreeView];
+        }
 
-		_minimumFrameSize = minimumBoundsSize;
+        // Whatever is about to be laid out again is no longer stable.
+        [self unrasterizeSubtreesNeedingLayout];
 
-        // Set the TreeGraph's frame size.
-        [self updateFrameSizeForContentAndClipView];
+        // Do recursive graph layout, starting at our rootSubtreeView.
+        CGSize rootSubtreeViewSize = [rootSubtreeView layoutGraphIfNeeded];
+
+        // Size the TreeGraph and position its root SubtreeView.
+        [self updateFrameForRootSubtreeViewSize:rootSubtreeViewSize];
 
-        // Position the TreeGraph's root SubtreeView.
-        [self updateRootSubtreeViewPositionForSize:rootSubtreeViewSize];
-        
 		if (( self.treeGraphOrientation == PSTreeGraphOrientationStyleHorizontalFlipped ) ||
             ( self.treeGraphOrientation == PSTreeGraphOrientationStyleVerticalFlipped )){
             [rootSubtreeView flipTreeGraph];
         }
+
+        // Now that every frame is final, build the connecting lines of the subtrees laid out again.
+        [rootSubtreeView updateConnectionsIfNeededForTreeGraph:self];
+
+        // Nodes shared between parents may have moved, or been shown or hidden.
+        [self updateCrossEdges];
+
+        // Expanding subtrees may have revealed stale subtrees, and nodes still showing placeholder content.
+        [self updateStaleSubtreesInVisibleRect];
+        [self updateContentPrefetching];
+
+        // Only the choice that follows a layout says whether bitmaps survive relayout.
+        _countsRasterizationLookups = YES;
+        [self updateRasterizedSubtrees];
+        _countsRasterizationLookups = NO;
+
+        [self invalidateNavigationIndex];
+
+        NSDictionary *userInfo = nil;
+        if ( _changedRectReportingCount > 0 && CGSizeEqualToSize(previousSize, self.bounds.size) ) {
+            userInfo = @{ PSTreeGraphViewChangedRectKey : [NSValue valueWithCGRect:[self rectOfFramesChangedSince:previousFrames]] };
+        }
+        [[NSNotificationCenter defaultCenter] postNotificationName:PSTreeGraphViewDidLayoutNotification object:self userInfo:userInfo];
+
         return rootSubtreeViewSize;
     } else {
         return rootSubtreeView ? rootSubtreeView.frame.size : CGSizeZero;
@@ -503,6 +1103,9 @@
 
 - (BOOL) needsGraphLayout
 {
+    if (_pendingStyleInvalidation & PSTreeGraphStyleInvalidationLayout) {
+        return YES;
+    }
     return self.rootSubtreeView.needsGraphLayout;
 }
 
@@ -530,41 +1133,890 @@
 }
 
 
-#pragma mark - Scrolling
+#pragma mark - Animation Support
 
-- (CGRect) boundsOfModelNodes:(NSSet *)modelNodes
+- (void) beginReportingChangedRects
 {
-    CGRect boundingBox = CGRectZero;
-    BOOL   firstNodeFound = NO;
-    for (id <PSTreeGraphModelNode> modelNode in modelNodes) {
-        PSBaseSubtreeView *subtreeView = [self subtreeViewForModelNode:modelNode];
-        if ( subtreeView && (subtreeView.hidden == NO) ) {
-            UIView *nodeView = subtreeView.nodeView;
-            if (nodeView) {
-                CGRect rect = [self convertRect:nodeView.bounds fromView:nodeView];
+    ++_changedRectReportingCount;
+}
 
-                if (!firstNodeFound) {
-                    // The first node found gives us the starting boundingBox, after
-                    // that we take the take union of each successive node.
-                    boundingBox = rect;
-                    firstNodeFound = YES;
-                } else {
-                    boundingBox = CGRectUnion(boundingBox, rect);
-                }
-            }
-        }
+- (void) endReportingChangedRects
+{
+    NSAssert(_changedRectReportingCount > 0, @"Unbalanced call to -endReportingChangedRects");
+    if (_changedRectReportingCount > 0) {
+        --_changedRectReportingCount;
     }
+}
 
-    return boundingBox;
+- (NSMapTable *) framesForLayoutOfRootSubtreeView
+{
+    PSBaseSubtreeView *rootSubtreeView = self.rootSubtreeView;
+    NSMapTable *frames = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsObjectPointerPersonality
+                                               valueOptions:NSPointerFunctionsStrongMemory];
+    [frames setObject:[NSValue valueWithCGRect:rootSubtreeView.frame] forKey:rootSubtreeView];
+    [self recordFramesForLayoutOfSubtreeView:rootSubtreeView into:frames];
+    return frames;
 }
 
-- (void) scrollModelNodesToVisible:(NSSet *)modelNodes animated:(BOOL)animated
+- (void) recordFramesForLayoutOfSubtreeView:(PSBaseSubtreeView *)subtreeView into:(NSMapTable *)frames
 {
-    CGRect targetRect = [self boundsOfModelNodes:modelNodes];
-    if (!CGRectIsEmpty(targetRect)) {
-        CGFloat padding = self.contentMargin;
+    // Relayout only moves the direct subviews of SubtreeViews that need layout, so that's all we record.
+    if ( !subtreeView.needsGraphLayout ) {
+        return;
+    }
 
-		UIScrollView *parentScroll = (UIScrollView *)self.superview;
+    for (UIView *subview in subtreeView.subviews) {
+        [frames setObject:[NSValue valueWithCGRect:subview.frame] forKey:subview];
+        if ([subview isKindOfClass:[PSBaseSubtreeView class]]) {
+            [self recordFramesForLayoutOfSubtreeView:(PSBaseSubtreeView *)subview into:frames];
+        }
+    }
+}
+
+- (CGRect) rectOfFramesChangedSince:(NSMapTable *)previousFrames
+{
+    // The union of the old and new frames of everything that moved or resized, in our coordinates.
+    // A view's old frame is placed using its superview's new position, but a superview that moved is
+    // in the table too, and its old and new frames cover the difference.
+    CGRect changedRect = CGRectNull;
+    for (UIView *view in previousFrames) {
+        CGRect previousFrame = [[previousFrames objectForKey:view] CGRectValue];
+        CGRect frame = view.frame;
+        if ( CGRectEqualToRect(previousFrame, frame) ) {
+            continue;
+        }
+        UIView *superview = view.superview;
+        changedRect = CGRectUnion(changedRect, [self convertRect:previousFrame fromView:superview]);
+        changedRect = CGRectUnion(changedRect, [self convertRect:frame fromView:superview]);
+    }
+    return changedRect;
+}
+
+- (void) animateFramesChangedSince:(NSMapTable *)previousFrames
+{
+    NSTimeInterval duration = PSTreeGraphLayoutAnimationDuration;
+    CAMediaTimingFunction *timingFunction = [CAMediaTimingFunction functionWithName:kCAMediaTimingFunctionEaseOut];
+
+    // Animate the position of each view that moved within its superview.  A view that moved along with
+    // its superview doesn't need animating itself.
+    NSHashTable *superviewsWithMovedSubviews = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
+    NSMutableArray *connectorsViews = [NSMutableArray array];
+
+    for (UIView *view in previousFrames) {
+        if ( [view isKindOfClass:[PSBaseBranchView class]] ) {
+            [connectorsViews addObject:view];
+            continue;
+        }
+
+        CGRect previousFrame = [[previousFrames objectForKey:view] CGRectValue];
+        CGRect frame = view.frame;
+        if ( view.hidden || CGPointEqualToPoint(previousFrame.origin, frame.origin) ) {
+            continue;
+        }
+
+        CALayer *layer = view.layer;
+        CGPoint anchorPoint = layer.anchorPoint;
+        CGPoint previousPosition = CGPointMake(CGRectGetMinX(previousFrame) + anchorPoint.x * previousFrame.size.width,
+                                               CGRectGetMinY(previousFrame) + anchorPoint.y * previousFrame.size.height);
+
+        CABasicAnimation *animation = [CABasicAnimation animationWithKeyPath:@"position"];
+        animation.fromValue = [NSValue valueWithCGPoint:previousPosition];
+        animation.toValue = [NSValue valueWithCGPoint:layer.position];
+        animation.duration = duration;
+        animation.timingFunction = timingFunction;
+        [layer addAnimation:animation forKey:@"PSTreeGraphLayoutPosition"];
+
+        if ( view.superview ) {
+            [superviewsWithMovedSubviews addObject:view.superview];
+        }
+    }
+
+    // Connecting lines are only redrawn for their final layout.  Rather than show them in place
+    // before the nodes get there, keep them hidden until the nodes have nearly arrived, then fade them in.
+    for (UIView *connectorsView in connectorsViews) {
+        if ( connectorsView.hidden || ![superviewsWithMovedSubviews containsObject:connectorsView.superview] ) {
+            continue;
+        }
+
+        CAKeyframeAnimation *animation = [CAKeyframeAnimation animationWithKeyPath:@"opacity"];
+        animation.values = @[ @0.0f, @0.0f, @1.0f ];
+        animation.keyTimes = @[ @0.0f, @0.6f, @1.0f ];
+        animation.duration = duration;
+        [connectorsView.layer addAnimation:animation forKey:@"PSTreeGraphLayoutFade"];
+    }
+}
+
+- (CGSize) layoutGraphIfNeededAnimated:(BOOL)animated
+{
+    // Style changes may call for layout.  Apply them first, so we record the right frames.
+    [self updateStyleIfNeeded];
+
+    PSBaseSubtreeView *rootSubtreeView = self.rootSubtreeView;
+    BOOL animateLayout = animated && self.animatesLayout && !self.layoutAnimationSuppressed;
+
+    if ( !animateLayout || ![self needsGraphLayout] || rootSubtreeView == nil ) {
+        return [self layoutGraphIfNeeded];
+    }
+
+    // Remember where everything that relayout might move was.  Layout reuses these to report what changed.
+    NSMapTable *previousFrames = [self framesForLayoutOfRootSubtreeView];
+
+    // Lay out in place, without implicit animations, then animate only what moved.
+    [CATransaction begin];
+    [CATransaction setDisableActions:YES];
+
+    CGSize rootSubtreeViewSize = [self layoutGraphIfNeededWithPreviousFrames:previousFrames];
+    [self animateFramesChangedSince:previousFrames];
+
+    [CATransaction commit];
+
+    return rootSubtreeViewSize;
+}
+
+
+#pragma mark - Content Prefetching
+
+- (BOOL) prefetchesNodeContent
+{
+    return [self.delegate respondsToSelector:@selector(treeGraph:prefetchContentForModelNodes:)];
+}
+
+- (CGRect) visibleGraphRect
+{
+    UIScrollView *enclosingScrollView = (UIScrollView *)self.superview;
+    if ( enclosingScrollView && [enclosingScrollView isKindOfClass:[UIScrollView class]] ) {
+        return CGRectIntersection(self.bounds, [self convertRect:enclosingScrollView.bounds fromView:enclosingScrollView]);
+    }
+    return self.bounds;
+}
+
+- (void) collectPlaceholderModelNodesOfSubtreeView:(PSBaseSubtreeView *)subtreeView
+                                        withOrigin:(CGPoint)parentOrigin
+                                            inRect:(CGRect)prefetchRect
+                                       visibleRect:(CGRect)visibleRect
+                                   prefetchedNodes:(NSMutableSet *)prefetchedNodes
+                                     visibleNodes:(NSMutableArray *)visibleNodes
+{
+    // Work in TreeGraph coordinates by accumulating frame origins, rather than converting rects between
+    // views.  A SubtreeView's frame encloses all of its visible descendants, so whole subtrees outside
+    // the prefetch rect are skipped.
+
+    CGRect frame = subtreeView.frame;
+    frame.origin.x += parentOrigin.x;
+    frame.origin.y += parentOrigin.y;
+
+    if ( subtreeView.hidden || !CGRectIntersectsRect(frame, prefetchRect) ) {
+        return;
+    }
+
+    id <PSTreeGraphModelNode> modelNode = subtreeView.modelNode;
+    if ( [_placeholderModelNodes containsObject:modelNode] ) {
+        CGRect nodeRect = CGRectOffset(subtreeView.nodeView.frame, frame.origin.x, frame.origin.y);
+        if ( CGRectIntersectsRect(nodeRect, visibleRect) ) {
+            [visibleNodes addObject:modelNode];
+        } else if ( CGRectIntersectsRect(nodeRect, prefetchRect) ) {
+            [prefetchedNodes addObject:modelNode];
+        }
+    }
+
+    if ( subtreeView.expanded ) {
+        for (UIView *subview in subtreeView.subviews) {
+            if ([subview isKindOfClass:[PSBaseSubtreeView class]]) {
+                [self collectPlaceholderModelNodesOfSubtreeView:(PSBaseSubtreeView *)subview
+                                                     withOrigin:frame.origin
+                                                         inRect:prefetchRect
+                                                    visibleRect:visibleRect
+                                                prefetchedNodes:prefetchedNodes
+                                                   visibleNodes:visibleNodes];
+            }
+        }
+    }
+}
+
+- (void) updateContentPrefetching
+{
+    if ( _placeholderModelNodes.count == 0 || ![self prefetchesNodeContent] ) {
+        return;
+    }
+
+    // Look one screen ahead in the direction we are scrolling, or half a screen all around if we
+    // aren't scrolling.
+    CGRect visibleRect = [self visibleGraphRect];
+    CGFloat dx = 0.0;
+    CGFloat dy = 0.0;
+    if ( !CGRectIsNull(_lastVisibleRect) ) {
+        dx = CGRectGetMinX(visibleRect) - CGRectGetMinX(_lastVisibleRect);
+        dy = CGRectGetMinY(visibleRect) - CGRectGetMinY(_lastVisibleRect);
+    }
+    _lastVisibleRect = visibleRect;
+
+    CGRect prefetchRect;
+    if ( dx == 0.0 && dy == 0.0 ) {
+        prefetchRect = CGRectInset(visibleRect, -0.5 * visibleRect.size.width, -0.5 * visibleRect.size.height);
+    } else {
+        CGFloat ahead = hypot(dx, dy);
+        prefetchRect = CGRectUnion(visibleRect,
+                                   CGRectOffset(visibleRect,
+                                                dx / ahead * visibleRect.size.width,
+                                                dy / ahead * visibleRect.size.height));
+    }
+
+    NSMutableSet *prefetchedNodes = [NSMutableSet set];
+    NSMutableArray *visibleNodes = [NSMutableArray array];
+    PSBaseSubtreeView *rootSubtreeView = self.rootSubtreeView;
+    if ( rootSubtreeView ) {
+        [self collectPlaceholderModelNodesOfSubtreeView:rootSubtreeView
+                                             withOrigin:CGPointZero
+                                                 inRect:prefetchRect
+                                            visibleRect:visibleRect
+                                        prefetchedNodes:prefetchedNodes
+                                           visibleNodes:visibleNodes];
+    }
+
+    // Nodes we were prefetching that have left the prefetch rect without being shown.
+    NSMutableSet *cancelledNodes = [_prefetchingModelNodes mutableCopy];
+    [cancelledNodes minusSet:prefetchedNodes];
+    [cancelledNodes minusSet:[NSSet setWithArray:visibleNodes]];
+
+    // Nodes newly inside the prefetch rect.  Visible nodes are included, if nobody asked for them yet,
+    // so the delegate always hears about a node before being asked to configure it.
+    NSMutableSet *newNodes = [prefetchedNodes mutableCopy];
+    [newNodes addObjectsFromArray:visibleNodes];
+    [newNodes minusSet:_prefetchingModelNodes];
+
+    [_prefetchingModelNodes unionSet:newNodes];
+    [_prefetchingModelNodes minusSet:cancelledNodes];
+
+    id <PSTreeGraphDelegate> delegate = self.delegate;
+    if ( cancelledNodes.count > 0 && [delegate respondsToSelector:@selector(treeGraph:cancelPrefetchingContentForModelNodes:)] ) {
+        [delegate treeGraph:self cancelPrefetchingContentForModelNodes:cancelledNodes.allObjects];
+    }
+    if ( newNodes.count > 0 ) {
+        [delegate treeGraph:self prefetchContentForModelNodes:newNodes.allObjects];
+    }
+
+    if ( visibleNodes.count > 0 ) {
+        // These nodes are now on screen.  They stop being placeholders, and are configured with their real
+        // content on a later pass of the main queue, so scrolling never waits for the delegate.
+        for (id <PSTreeGraphModelNode> modelNode in visibleNodes) {
+            [_placeholderModelNodes removeObject:modelNode];
+            [_prefetchingModelNodes removeObject:modelNode];
+        }
+
+        __weak PSBaseTreeGraphView *weakSelf = self;
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [weakSelf configureNodeViewsForModelNodes:visibleNodes];
+        });
+    }
+}
+
+- (void) configureNodeViewsForModelNodes:(NSArray *)modelNodes
+{
+    id <PSTreeGraphDelegate> delegate = self.delegate;
+    if ( ![delegate conformsToProtocol:@protocol(PSTreeGraphDelegate)] ) {
+        return;
+    }
+    for (id <PSTreeGraphModelNode> modelNode in modelNodes) {
+        // The tree may have been rebuilt since these were scheduled.
+        UIView *nodeView = [self subtreeViewForModelNode:modelNode].nodeView;
+        if ( nodeView ) {
+            [delegate configureNodeView:nodeView withModelNode:modelNode];
+        }
+    }
+}
+
+- (void) discardContentPrefetching
+{
+    id <PSTreeGraphDelegate> delegate = self.delegate;
+    if ( _prefetchingModelNodes.count > 0 && [delegate respondsToSelector:@selector(treeGraph:cancelPrefetchingContentForModelNodes:)] ) {
+        [delegate treeGraph:self cancelPrefetchingContentForModelNodes:_prefetchingModelNodes.allObjects];
+    }
+    [_prefetchingModelNodes removeAllObjects];
+    [_placeholderModelNodes removeAllObjects];
+    _lastVisibleRect = CGRectNull;
+}
+
+
+#pragma mark - Subtree Rasterization
+
+- (void) setRasterizesStableSubtrees:(BOOL)flag
+{
+    if (_rasterizesStableSubtrees != flag) {
+        _rasterizesStableSubtrees = flag;
+        [self updateRasterizedSubtrees];
+    }
+}
+
+- (void) setMinimumRasterizedSubtreeArea:(CGFloat)newMinimumRasterizedSubtreeArea
+{
+    if (_minimumRasterizedSubtreeArea != newMinimumRasterizedSubtreeArea) {
+        _minimumRasterizedSubtreeArea = newMinimumRasterizedSubtreeArea;
+        [self updateRasterizedSubtrees];
+    }
+}
+
+- (void) setRasterizationCacheBudget:(NSUInteger)newRasterizationCacheBudget
+{
+    if (_rasterizationCacheBudget != newRasterizationCacheBudget) {
+        _rasterizationCacheBudget = newRasterizationCacheBudget;
+        [self updateRasterizedSubtrees];
+    }
+}
+
+- (NSUInteger) rasterizedSubtreeCount
+{
+    return _rasterizedSubtreeViews.count;
+}
+
+- (CGFloat) rasterizationCacheHitRate
+{
+    return (_rasterizationCacheLookups > 0) ? (CGFloat)_rasterizationCacheHits / (CGFloat)_rasterizationCacheLookups : 0.0;
+}
+
+- (void) resetRasterizationStatistics
+{
+    _rasterizationCacheLookups = 0;
+    _rasterizationCacheHits = 0;
+}
+
+- (void) setSubtreeView:(PSBaseSubtreeView *)subtreeView rasterized:(BOOL)flag
+{
+    CALayer *layer = subtreeView.layer;
+    if (flag) {
+        UIScreen *screen = self.window.screen ?: [UIScreen mainScreen];
+        layer.rasterizationScale = screen.scale;
+    }
+    layer.shouldRasterize = flag;
+}
+
+- (void) discardRasterizedSubtrees
+{
+    for (PSBaseSubtreeView *subtreeView in _rasterizedSubtreeViews) {
+        [self setSubtreeView:subtreeView rasterized:NO];
+    }
+    [_rasterizedSubtreeViews removeAllObjects];
+    [_interactedSubtreeViews removeAllObjects];
+    _rasterizationCacheSize = 0;
+}
+
+- (void) unrasterizeSubtreesNeedingLayout
+{
+    for (PSBaseSubtreeView *subtreeView in [_rasterizedSubtreeViews allObjects]) {
+        if (subtreeView.needsGraphLayout) {
+            [self setSubtreeView:subtreeView rasterized:NO];
+            [_rasterizedSubtreeViews removeObject:subtreeView];
+        }
+    }
+
+    // Touched subtrees become candidates again once the tree changes.
+    [_interactedSubtreeViews removeAllObjects];
+}
+
+- (void) noteInteractionAtPoint:(CGPoint)p
+{
+    if (_rasterizedSubtreeViews.count == 0) {
+        return;
+    }
+
+    // Find the flattened subtree, if any, under the touch.
+    UIView *hitView = [self hitTest:p withEvent:nil];
+    while (hitView && hitView != self) {
+        if ([_rasterizedSubtreeViews containsObject:hitView]) {
+            [_interactedSubtreeViews addObject:hitView];
+            [self updateRasterizedSubtrees];
+            return;
+        }
+        hitView = hitView.superview;
+    }
+}
+
+- (void) addSubtreeViewAndAncestorsOfView:(UIView *)view toTable:(NSHashTable *)subtreeViews
+{
+    while (view && view != self) {
+        if ([view isKindOfClass:[PSBaseSubtreeView class]]) {
+            [subtreeViews addObject:view];
+        }
+        view = view.superview;
+    }
+}
+
+- (void) chooseRasterizedSubtreesOfSubtreeView:(PSBaseSubtreeView *)subtreeView
+                                    withOrigin:(CGPoint)parentOrigin
+                                   visibleRect:(CGRect)visibleRect
+                                      unstable:(NSHashTable *)unstableSubtreeViews
+                                         scale:(CGFloat)scale
+                                    bytesUsed:(NSUInteger *)bytesUsed
+                                        chosen:(NSHashTable *)chosenSubtreeViews
+{
+    // A collapsed subtree shows a single node, so there is nothing to gain by flattening it.
+    if ( subtreeView.hidden || !subtreeView.expanded ) {
+        return;
+    }
+
+    CGRect frame = CGRectOffset(subtreeView.frame, parentOrigin.x, parentOrigin.y);
+    if ( !CGRectIntersectsRect(frame, visibleRect) ) {
+        // Off screen.  Core Animation doesn't composite it anyway.
+        return;
+    }
+
+    // Descendants are smaller still.
+    if ( frame.size.width * frame.size.height < self.minimumRasterizedSubtreeArea ) {
+        return;
+    }
+
+    // The bitmap covers the whole subtree, on screen or not.  Core Animation won't cache a rasterized
+    // layer much larger than the screen, and renders it offscreen every frame instead, which is worse
+    // than not flattening it.  So nothing larger than the visible rect is a candidate.
+    BOOL fitsOnScreen = ( frame.size.width <= visibleRect.size.width && frame.size.height <= visibleRect.size.height );
+
+    // Flatten the largest stable subtrees that fit the budget.  Otherwise look for smaller ones within.
+    if ( fitsOnScreen && ![unstableSubtreeViews containsObject:subtreeView] && !subtreeView.needsGraphLayout ) {
+        NSUInteger bytes = (NSUInteger)(ceil(frame.size.width * scale) * ceil(frame.size.height * scale) * 4.0);
+        if ( *bytesUsed + bytes <= self.rasterizationCacheBudget ) {
+            [chosenSubtreeViews addObject:subtreeView];
+            *bytesUsed += bytes;
+            return;
+        }
+    }
+
+    for (UIView *subview in subtreeView.subviews) {
+        if ([subview isKindOfClass:[PSBaseSubtreeView class]]) {
+            [self chooseRasterizedSubtreesOfSubtreeView:(PSBaseSubtreeView *)subview
+                                             withOrigin:frame.origin
+                                            visibleRect:visibleRect
+                                               unstable:unstableSubtreeViews
+                                                  scale:scale
+                                             bytesUsed:bytesUsed
+                                                 chosen:chosenSubtreeViews];
+        }
+    }
+}
+
+- (void) updateRasterizedSubtrees
+{
+    PSBaseSubtreeView *rootSubtreeView = self.rootSubtreeView;
+    if ( !self.rasterizesStableSubtrees || rootSubtreeView == nil ) {
+        if (_rasterizedSubtreeViews.count > 0) {
+            [self discardRasterizedSubtrees];
+        }
+        return;
+    }
+
+    // Subtrees holding a selected or touched node, and everything above them, must stay live.
+    NSHashTable *unstableSubtreeViews = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
+    for (id <PSTreeGraphModelNode> modelNode in self.selectedModelNodes) {
+        [self addSubtreeViewAndAncestorsOfView:[self subtreeViewForModelNode:modelNode] toTable:unstableSubtreeViews];
+    }
+    for (PSBaseSubtreeView *subtreeView in _interactedSubtreeViews) {
+        [self addSubtreeViewAndAncestorsOfView:subtreeView toTable:unstableSubtreeViews];
+    }
+
+    UIScreen *screen = self.window.screen ?: [UIScreen mainScreen];
+    NSHashTable *chosenSubtreeViews = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
+    NSUInteger bytesUsed = 0;
+
+    [self chooseRasterizedSubtreesOfSubtreeView:rootSubtreeView
+                                     withOrigin:CGPointZero
+                                    visibleRect:[self visibleGraphRect]
+                                       unstable:unstableSubtreeViews
+                                          scale:screen.scale
+                                     bytesUsed:&bytesUsed
+                                         chosen:chosenSubtreeViews];
+
+    // Unflatten what is no longer wanted, then flatten what is new.  A subtree that stays flattened
+    // keeps its bitmap.  Right after a layout, that counts as a hit.
+    for (PSBaseSubtreeView *subtreeView in _rasterizedSubtreeViews) {
+        if (![chosenSubtreeViews containsObject:subtreeView]) {
+            [self setSubtreeView:subtreeView rasterized:NO];
+        }
+    }
+
+    for (PSBaseSubtreeView *subtreeView in chosenSubtreeViews) {
+        BOOL reused = [_rasterizedSubtreeViews containsObject:subtreeView];
+        if (_countsRasterizationLookups) {
+            ++_rasterizationCacheLookups;
+            if (reused) {
+                ++_rasterizationCacheHits;
+            }
+        }
+        if (!reused) {
+            [self setSubtreeView:subtreeView rasterized:YES];
+        }
+    }
+
+    _rasterizedSubtreeViews = chosenSubtreeViews;
+    _rasterizationCacheSize = bytesUsed;
+}
+
+
+#pragma mark - Shared Nodes
+
+- (void) updateCrossEdges
+{
+    if (_crossEdges.count == 0) {
+        _crossEdgeLayer.path = NULL;
+        return;
+    }
+
+    if (_crossEdgeLayer == nil) {
+        _crossEdgeLayer = [CAShapeLayer layer];
+        _crossEdgeLayer.fillColor = nil;
+        _crossEdgeLayer.lineDashPattern = @[ @4, @4 ];
+
+        // Above every SubtreeView, so the edges aren't hidden behind the subtrees they cross.
+        _crossEdgeLayer.zPosition = 1.0f;
+        [self.layer addSublayer:_crossEdgeLayer];
+    }
+
+    _crossEdgeLayer.frame = self.bounds;
+    _crossEdgeLayer.strokeColor = self.connectingLineColor.CGColor;
+    _crossEdgeLayer.lineWidth = self.connectingLineWidth;
+
+    PSTreeGraphOrientationStyle orientation = self.treeGraphOrientation;
+    BOOL horizontal = ( orientation == PSTreeGraphOrientationStyleHorizontal ||
+                        orientation == PSTreeGraphOrientationStyleHorizontalFlipped );
+    BOOL flipped = ( orientation == PSTreeGraphOrientationStyleHorizontalFlipped ||
+                     orientation == PSTreeGraphOrientationStyleVerticalFlipped );
+
+    // Run each edge from the trailing edge of the parent's nodeView to the leading edge of the
+    // shared node's nodeView, the same way a branch connects a parent to its own children.
+    CGMutablePathRef path = CGPathCreateMutable();
+    for (NSArray *crossEdge in _crossEdges) {
+        PSBaseSubtreeView *parentSubtreeView = [self subtreeViewForModelNode:crossEdge[0]];
+        PSBaseSubtreeView *childSubtreeView = [self subtreeViewForModelNode:crossEdge[1]];
+
+        // Only join nodes that are both on screen, a collapsed parent hides its edges.
+        if ( ![self subtreeViewIsShown:parentSubtreeView] || ![self subtreeViewIsShown:childSubtreeView] ) {
+            continue;
+        }
+
+        UIView *parentNodeView = parentSubtreeView.nodeView;
+        UIView *childNodeView = childSubtreeView.nodeView;
+        CGRect parentRect = [self convertRect:parentNodeView.bounds fromView:parentNodeView];
+        CGRect childRect = [self convertRect:childNodeView.bounds fromView:childNodeView];
+
+        CGPoint start, end;
+        if (horizontal) {
+            start = CGPointMake(flipped ? CGRectGetMinX(parentRect) : CGRectGetMaxX(parentRect), CGRectGetMidY(parentRect));
+            end = CGPointMake(flipped ? CGRectGetMaxX(childRect) : CGRectGetMinX(childRect), CGRectGetMidY(childRect));
+        } else {
+            start = CGPointMake(CGRectGetMidX(parentRect), flipped ? CGRectGetMinY(parentRect) : CGRectGetMaxY(parentRect));
+            end = CGPointMake(CGRectGetMidX(childRect), flipped ? CGRectGetMaxY(childRect) : CGRectGetMinY(childRect));
+        }
+
+        CGPathMoveToPoint(path, NULL, start.x, start.y);
+        CGPathAddLineToPoint(path, NULL, end.x, end.y);
+    }
+
+    // Layout already runs with implicit animations disabled, this covers style changes.
+    [CATransaction begin];
+    [CATransaction setDisableActions:YES];
+    _crossEdgeLayer.path = path;
+    [CATransaction commit];
+
+    CGPathRelease(path);
+}
+
+
+#pragma mark - Layout Cache
+
+- (BOOL) restoreLayoutFromCache
+{
+    if (self.layoutCacheURL == nil || self.rootSubtreeView == nil) {
+        return NO;
+    }
+
+    PSTreeGraphLayoutCache *layoutCache = [[PSTreeGraphLayoutCache alloc] initWithContentsOfURL:self.layoutCacheURL];
+    if (![layoutCache applyToTreeGraph:self]) {
+        return NO;
+    }
+
+    // The cached frames are already flipped, if the orientation calls for it.  All that's left is
+    // what -layoutGraphIfNeeded does after laying out the root SubtreeView.
+    [self updateFrameForRootSubtreeViewSize:self.rootSubtreeView.frame.size];
+    _connectorPathRebuildCount = 0;
+    [self.rootSubtreeView updateConnectionsIfNeededForTreeGraph:self];
+    [self updateCrossEdges];
+
+    [self invalidateNavigationIndex];
+    [[NSNotificationCenter defaultCenter] postNotificationName:PSTreeGraphViewDidLayoutNotification object:self];
+
+    return YES;
+}
+
+- (BOOL) writeLayoutCache:(NSError **)error
+{
+    NSAssert(self.layoutCacheURL != nil, @"You must set a layoutCacheURL before writing the layout cache");
+
+    // Make sure we write the layout the user is actually looking at.
+    [self layoutGraphIfNeeded];
+
+    return [PSTreeGraphLayoutCache writeLayoutOfTreeGraph:self toURL:self.layoutCacheURL error:error];
+}
+
+
+#pragma mark - Searching
+
+- (void) buildSearchIndex
+{
+    // Discard the index for the previous modelRoot.  Any search in progress will be run again
+    // against the new index once it is ready.
+    _searchIndex = nil;
+    _searchKey = nil;
+    _searchMatches = @[];
+
+    // Builds can overlap (the delegate may change while one is running).  Only the latest counts.
+    NSUInteger generation = ++_searchIndexGeneration;
+
+    id <PSTreeGraphModelNode> root = self.modelRoot;
+    id <PSTreeGraphDelegate> delegate = self.delegate;
+    if (root == nil || ![delegate respondsToSelector:@selector(labelForModelNode:)]) {
+        return;
+    }
+
+    __weak PSBaseTreeGraphView *weakSelf = self;
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        PSTreeGraphSearchIndex *searchIndex =
+            [[PSTreeGraphSearchIndex alloc] initWithModelRoot:root
+                                                labelProvider:^NSString *(id <PSTreeGraphModelNode> modelNode) {
+                if ([(NSObject *)modelNode isKindOfClass:[PSTreeGraphForestNode class]]) {
+                    return nil;
+                }
+                return [delegate labelForModelNode:modelNode];
+            }];
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [weakSelf searchIndexDidFinishBuilding:searchIndex generation:generation];
+        });
+    });
+}
+
+- (void) searchIndexDidFinishBuilding:(PSTreeGraphSearchIndex *)searchIndex generation:(NSUInteger)generation
+{
+    // Ignore an index built for a modelRoot, or delegate, we are no longer showing.
+    if (generation != _searchIndexGeneration) {
+        return;
+    }
+
+    _searchIndex = searchIndex;
+    [self updateSearchMatches];
+}
+
+- (void) setSearchString:(NSString *)newSearchString
+{
+    if (_searchString != newSearchString) {
+        _searchString = [newSearchString copy];
+        [self updateSearchMatches];
+    }
+}
+
+- (void) updateSearchMatches
+{
+    NSString *key = (_searchString.length > 0) ? [PSTreeGraphSearchIndex normalizedString:_searchString] : nil;
+    if (_searchIndex == nil || key == nil) {
+        _searchKey = nil;
+        _searchMatches = @[];
+        _searchMatchTreeOrder = NSNotFound;
+        return;
+    }
+
+    // Typing another character can only narrow the matches, so refine the previous range instead of
+    // searching the whole index again.
+    NSRange range = _searchIndex.fullRange;
+    if (_searchKey != nil && [key hasPrefix:_searchKey]) {
+        range = _searchRange;
+    }
+    _searchRange = [_searchIndex rangeOfEntriesWithPrefix:key inRange:range];
+    _searchKey = key;
+
+    // The full list of matches is only gathered (and sorted) if someone asks for it.  Each keystroke
+    // just finds the first match in the tree, and shows that.
+    _searchMatches = nil;
+    _searchMatchTreeOrder = NSNotFound;
+    [self showSearchMatchByRelativeIndex:1];
+}
+
+- (NSArray *) searchMatches
+{
+    if (_searchMatches == nil) {
+        // Only nodes we have built views for can be shown and selected.
+        NSMutableArray *matches = [NSMutableArray array];
+        for (id <PSTreeGraphModelNode> modelNode in [_searchIndex modelNodesInRange:_searchRange]) {
+            if ([self subtreeViewForModelNode:modelNode] != nil) {
+                [matches addObject:modelNode];
+            }
+        }
+        _searchMatches = [matches copy];
+    }
+    return _searchMatches;
+}
+
+- (void) revealModelNode:(id <PSTreeGraphModelNode> )modelNode
+{
+    // Expand each collapsed ancestor of the given node, leaving everything beside them as it is.
+    UIView *ancestor = [self subtreeViewForModelNode:modelNode].superview;
+    while ([ancestor isKindOfClass:[PSBaseSubtreeView class]]) {
+        PSBaseSubtreeView *ancestorSubtreeView = (PSBaseSubtreeView *)ancestor;
+        if (ancestorSubtreeView.expanded && !ancestorSubtreeView.hidden) {
+            // Everything above a visible, expanded subtree is visible and expanded too.
+            break;
+        }
+        if (!ancestorSubtreeView.expanded) {
+            [ancestorSubtreeView setExpanded:YES recursively:NO];
+        }
+        ancestor = ancestor.superview;
+    }
+
+    // Lay out the expanded subtrees, and their ancestors, in a single pass.
+    [self layoutGraphIfNeeded];
+}
+
+- (void) showSearchMatchByRelativeIndex:(NSInteger)relativeIndex
+{
+    if (_searchIndex == nil || _searchKey == nil) {
+        return;
+    }
+
+    // Step through the matches in tree order, wrapping around at either end.
+    NSUInteger treeOrder = _searchMatchTreeOrder;
+    NSUInteger steps = (NSUInteger)ABS(relativeIndex);
+    for (NSUInteger step = 0; step < steps; step++) {
+        NSUInteger next;
+        if (relativeIndex > 0) {
+            next = [_searchIndex treeOrderOfModelNodeInRange:_searchRange following:treeOrder];
+            if (next == NSNotFound) {
+                next = [_searchIndex treeOrderOfModelNodeInRange:_searchRange following:NSNotFound];
+            }
+        } else {
+            next = [_searchIndex treeOrderOfModelNodeInRange:_searchRange preceding:treeOrder];
+            if (next == NSNotFound) {
+                next = [_searchIndex treeOrderOfModelNodeInRange:_searchRange preceding:NSNotFound];
+            }
+        }
+        if (next == NSNotFound) {
+            // No matches.  Don't leave the previous search's match selected.
+            _searchMatchTreeOrder = NSNotFound;
+            [self updateVisibleSearchMatches];
+            return;
+        }
+        treeOrder = next;
+    }
+    _searchMatchTreeOrder = treeOrder;
+
+    // Reveal only the current match.  Expanding every match of a short search string could lay out
+    // most of the tree.
+    id <PSTreeGraphModelNode> modelNode = [_searchIndex modelNodeAtTreeOrder:treeOrder];
+    if ([self subtreeViewForModelNode:modelNode] != nil) {
+        [self revealModelNode:modelNode];
+        [self scrollModelNodesToVisible:[NSSet setWithObject:modelNode] animated:YES];
+    }
+    [self updateVisibleSearchMatches];
+}
+
+- (void) collectSearchMatchesOfSubtreeView:(PSBaseSubtreeView *)subtreeView
+                                withOrigin:(CGPoint)parentOrigin
+                                    inRect:(CGRect)visibleRect
+                                      into:(NSMutableSet *)matches
+{
+    CGRect frame = CGRectOffset(subtreeView.frame, parentOrigin.x, parentOrigin.y);
+    if ( subtreeView.hidden || !CGRectIntersectsRect(frame, visibleRect) ) {
+        return;
+    }
+
+    CGRect nodeRect = CGRectOffset(subtreeView.nodeView.frame, frame.origin.x, frame.origin.y);
+    if ( CGRectIntersectsRect(nodeRect, visibleRect) &&
+         [_searchIndex modelNode:subtreeView.modelNode matchesPrefix:_searchKey] ) {
+        [matches addObject:subtreeView.modelNode];
+    }
+
+    if ( subtreeView.expanded ) {
+        for (UIView *subview in subtreeView.subviews) {
+            if ([subview isKindOfClass:[PSBaseSubtreeView class]]) {
+                [self collectSearchMatchesOfSubtreeView:(PSBaseSubtreeView *)subview
+                                             withOrigin:frame.origin
+                                                 inRect:visibleRect
+                                                   into:matches];
+            }
+        }
+    }
+}
+
+- (void) updateVisibleSearchMatches
+{
+    if (_searchIndex == nil || _searchKey == nil) {
+        return;
+    }
+
+    // Select the current match, and any other matches on screen.  Only the visible part of the
+    // tree is walked, so this is cheap enough to do as the user scrolls.  With no matches at all,
+    // this clears the selection.
+    NSMutableSet *matches = [NSMutableSet set];
+    if (_searchMatchTreeOrder != NSNotFound) {
+        id <PSTreeGraphModelNode> currentMatch = [_searchIndex modelNodeAtTreeOrder:_searchMatchTreeOrder];
+        if ([self subtreeViewForModelNode:currentMatch] != nil) {
+            [matches addObject:currentMatch];
+        }
+    }
+
+    PSBaseSubtreeView *rootSubtreeView = self.rootSubtreeView;
+    if (rootSubtreeView) {
+        [self collectSearchMatchesOfSubtreeView:rootSubtreeView
+                                     withOrigin:CGPointZero
+                                         inRect:[self visibleGraphRect]
+                                           into:matches];
+    }
+
+    if (![matches isEqualToSet:self.selectedModelNodes]) {
+        self.selectedModelNodes = matches;
+    }
+}
+
+- (IBAction) showNextSearchMatch:(id)sender
+{
+    [self showSearchMatchByRelativeIndex:1];
+}
+
+- (IBAction) showPreviousSearchMatch:(id)sender
+{
+    [self showSearchMatchByRelativeIndex:-1];
+}
+
+
+#pragma mark - Scrolling
+
+- (CGRect) boundsOfModelNodes:(NSSet *)modelNodes
+{
+    CGRect boundingBox = CGRectZero;
+    BOOL   firstNodeFound = NO;
+    for (id <PSTreeGraphModelNode> modelNode in modelNodes) {
+        PSBaseSubtreeView *subtreeView = [self subtreeViewForModelNode:modelNode];
+        if ( subtreeView && (subtreeView.hidden == NO) ) {
+            UIView *nodeView = subtreeView.nodeView;
+            if (nodeView) {
+                CGRect rect = [self convertRect:nodeView.bounds fromView:nodeView];
+
+                if (!firstNodeFound) {
+                    // The first node found gives us the starting boundingBox, after
+                    // that we take the take union of each successive node.
+                    boundingBox = rect;
+                    firstNodeFound = YES;
+                } else {
+                    boundingBox = CGRectUnion(boundingBox, rect);
+                }
+            }
+        }
+    }
+
+    return boundingBox;
+}
+
+- (void) scrollModelNodesToVisible:(NSSet *)modelNodes animated:(BOOL)animated
+{
+    CGRect targetRect = [self boundsOfModelNodes:modelNodes];
+    if (!CGRectIsEmpty(targetRect)) {
+        CGFloat padding = self.contentMargin;
+
+		UIScrollView *parentScroll = (UIScrollView *)self.superview;
 
 		if ( parentScroll && [parentScroll isKindOfClass:[UIScrollView class]] ) {
             targetRect = CGRectInset(targetRect, -padding, -padding);
@@ -582,6 +2034,24 @@
 
 #pragma mark - Data Source
 
+- (NSArray *) modelRoots
+{
+    id <PSTreeGraphModelNode> root = self.modelRoot;
+    if ([root isKindOfClass:[PSTreeGraphForestNode class]]) {
+        return [root childModelNodes];
+    }
+    return root ? @[ root ] : @[];
+}
+
+- (void) setModelRoots:(NSArray *)newModelRoots
+{
+    if (newModelRoots.count > 1) {
+        self.modelRoot = [[PSTreeGraphForestNode alloc] initWithRootModelNodes:newModelRoots];
+    } else {
+        self.modelRoot = newModelRoots.firstObject;
+    }
+}
+
 - (void) setModelRoot:(id <PSTreeGraphModelNode> )newModelRoot
 {
     NSParameterAssert(newModelRoot == nil || [newModelRoot conformsToProtocol:@protocol(PSTreeGraphModelNode)]);
@@ -590,24 +2060,54 @@
         PSBaseSubtreeView *rootSubtreeView = self.rootSubtreeView;
         [rootSubtreeView removeFromSuperview];
         [_modelNodeToSubtreeViewMapTable removeAllObjects];
+        [self discardContentPrefetching];
+        [self discardRasterizedSubtrees];
+        [_staleSubtreeViews removeAllObjects];
+        [self invalidateStaleSubtreeLookup];
+        [_crossEdges removeAllObjects];
 
         // Discard any previous selection.
         self.selectedModelNodes = [NSSet set];
 
+        // Forget keyboard moves made in the old tree.
+        _pendingNavigationModelNode = nil;
+        _pendingNavigationMoveCount = 0;
+
         // Switch to new modelRoot.
         _modelRoot = newModelRoot;
 
         // Discard and reload content.
         [self buildGraph];
+        [self buildSearchIndex];
         [self setNeedsDisplay];
         [self.rootSubtreeView resursiveSetSubtreeBordersNeedDisplay];
+
+        // A freshly built tree needs a full layout anyway, so a relayout asked for by style changes made
+        // before now (setting spacing before the modelRoot, say) is already covered.  Left pending, it
+        // would throw away a layout restored from the cache.
+        _pendingStyleInvalidation &= ~PSTreeGraphStyleInvalidationLayout;
+
+        // Reuse the last layout of this tree if we have one, otherwise lay it out.
+        [self restoreLayoutFromCache];
         [self layoutGraphIfNeeded];
 
-        // Start with modelRoot selected.
-        if ( _modelRoot ) {
-            self.selectedModelNodes = [NSSet setWithObject:_modelRoot];
+        // Start with modelRoot (or the first root of a forest) selected.
+        id <PSTreeGraphModelNode> selectableRootModelNode = self.selectableRootModelNode;
+        if ( selectableRootModelNode ) {
+            self.selectedModelNodes = [NSSet setWithObject:selectableRootModelNode];
             [self scrollSelectedModelNodesToVisibleAnimated:NO];
         }
+
+        // A cached layout, or no tree at all, doesn't go through layout.
+        [self updateCrossEdges];
+
+        // Start loading content for the nodes we are showing.
+        [self updateContentPrefetching];
+
+        // Layout may not have happened (no tree, or a cached layout), but observers need to know
+        // the tree was replaced.
+        [self invalidateNavigationIndex];
+        [[NSNotificationCenter defaultCenter] postNotificationName:PSTreeGraphViewDidLayoutNotification object:self];
     }
 }
 
@@ -627,6 +2127,8 @@
     
     [encoder encodeInt:_treeGraphOrientation forKey:@"treeGraphOrientation"];
     [encoder encodeInt:_connectingLineStyle forKey:@"connectingLineStyle"];
+
+    [encoder encodeObject:_layoutCacheURL forKey:@"layoutCacheURL"];
 }
 
 - (instancetype) initWithCoder:(NSCoder *)decoder
@@ -655,6 +2157,9 @@
             _treeGraphOrientation = [decoder decodeIntForKey:@"treeGraphOrientation"];
         if ([decoder containsValueForKey:@"connectingLineStyle"])
             _connectingLineStyle = [decoder decodeIntForKey:@"connectingLineStyle"];
+
+        if ([decoder containsValueForKey:@"layoutCacheURL"])
+            _layoutCacheURL = [decoder decodeObjectForKey:@"layoutCacheURL"];
     }
     return self;
 }
@@ -684,6 +2189,102 @@
 }
 
 
+#pragma mark - Navigation Index
+
+- (void) invalidateNavigationIndex
+{
+    _navigationIndexIsValid = NO;
+}
+
+- (void) addNavigationEntriesOfSubtreeView:(PSBaseSubtreeView *)subtreeView withOrigin:(CGPoint)parentOrigin
+{
+    if (subtreeView.hidden) {
+        return;
+    }
+
+    // Frames are relative to the enclosing SubtreeView.  Accumulate origins instead of converting.
+    CGRect frame = CGRectOffset(subtreeView.frame, parentOrigin.x, parentOrigin.y);
+
+    // The root of a forest isn't shown, so there is nothing to navigate to.
+    if ( !subtreeView.isForestRoot ) {
+        CGRect nodeFrame = CGRectOffset(subtreeView.nodeView.frame, frame.origin.x, frame.origin.y);
+
+        PSTreeGraphNavigationEntry *entry = &_navigationEntriesByX[_navigationEntryCount++];
+        entry->center = CGPointMake(CGRectGetMidX(nodeFrame), CGRectGetMidY(nodeFrame));
+        entry->nodeIndex = _navigationModelNodes.count;
+        [_navigationModelNodes addObject:subtreeView.modelNode];
+    }
+
+    if (!subtreeView.expanded) {
+        return;
+    }
+
+    for (UIView *subview in subtreeView.subviews) {
+        if ([subview isKindOfClass:[PSBaseSubtreeView class]]) {
+            [self addNavigationEntriesOfSubtreeView:(PSBaseSubtreeView *)subview withOrigin:frame.origin];
+        }
+    }
+}
+
+- (void) updateNavigationIndexIfNeeded
+{
+    if (_navigationIndexIsValid) {
+        return;
+    }
+    _navigationIndexIsValid = YES;
+
+    [_navigationModelNodes removeAllObjects];
+    _navigationEntryCount = 0;
+
+    // Every visible node has a SubtreeView, so this is enough room for all of them.
+    NSUInteger capacity = MAX(_modelNodeToSubtreeViewMapTable.count, 1);
+    _navigationEntriesByX = realloc(_navigationEntriesByX, capacity * sizeof(PSTreeGraphNavigationEntry));
+    _navigationEntriesByY = realloc(_navigationEntriesByY, capacity * sizeof(PSTreeGraphNavigationEntry));
+
+    PSBaseSubtreeView *rootSubtreeView = self.rootSubtreeView;
+    if (rootSubtreeView) {
+        [self addNavigationEntriesOfSubtreeView:rootSubtreeView withOrigin:CGPointZero];
+    }
+
+    memcpy(_navigationEntriesByY, _navigationEntriesByX, _navigationEntryCount * sizeof(PSTreeGraphNavigationEntry));
+    qsort(_navigationEntriesByX, _navigationEntryCount, sizeof(PSTreeGraphNavigationEntry), PSTreeGraphCompareNavigationEntriesByX);
+    qsort(_navigationEntriesByY, _navigationEntryCount, sizeof(PSTreeGraphNavigationEntry), PSTreeGraphCompareNavigationEntriesByY);
+}
+
+- (id <PSTreeGraphModelNode> ) modelNodeNearestToModelNode:(id <PSTreeGraphModelNode> )modelNode
+                                                     alongY:(BOOL)alongY
+                                                    forward:(BOOL)forward
+                                                   distance:(CGFloat)distance
+{
+    PSBaseSubtreeView *subtreeView = [self subtreeViewForModelNode:modelNode];
+    UIView *nodeView = subtreeView.nodeView;
+    if (nodeView == nil) {
+        return nil;
+    }
+
+    [self updateNavigationIndexIfNeeded];
+
+    CGRect nodeRect = [self convertRect:nodeView.bounds fromView:nodeView];
+    CGFloat along = alongY ? CGRectGetMidY(nodeRect) : CGRectGetMidX(nodeRect);
+    CGFloat across = alongY ? CGRectGetMidX(nodeRect) : CGRectGetMidY(nodeRect);
+
+    // Aim "distance" ahead, but accept anything that is at least a little way in the right direction.
+    CGFloat target = forward ? (along + distance) : (along - distance);
+    CGFloat lowerBound = forward ? (along + PSTreeGraphNavigationMinimumDistance) : -CGFLOAT_MAX;
+    CGFloat upperBound = forward ? CGFLOAT_MAX : (along - PSTreeGraphNavigationMinimumDistance);
+
+    NSUInteger index = PSTreeGraphNearestNavigationEntry(alongY ? _navigationEntriesByY : _navigationEntriesByX,
+                                                         _navigationEntryCount, alongY, target, across,
+                                                         lowerBound, upperBound);
+    if (index == NSNotFound) {
+        return nil;
+    }
+
+    PSTreeGraphNavigationEntry *entries = alongY ? _navigationEntriesByY : _navigationEntriesByX;
+    return _navigationModelNodes[entries[index].nodeIndex];
+}
+
+
 #pragma mark - Input and Navigation
 
 - (BOOL) canBecomeFirstResponder
@@ -699,6 +2300,16 @@
 
     // Identify the mdoel node (if any) that the user clicked, and make it the new selection.
     id <PSTreeGraphModelNode>  hitModelNode = [self modelNodeAtPoint:viewPoint];
+
+    // Keep the touched subtree live while the user works with it.
+    [self noteInteractionAtPoint:viewPoint];
+
+    // A touch replaces any keyboard moves still waiting for the next frame.
+    [_navigationDisplayLink invalidate];
+    _navigationDisplayLink = nil;
+    _pendingNavigationModelNode = nil;
+    _pendingNavigationMoveCount = 0;
+
     self.selectedModelNodes = (hitModelNode ? [NSSet setWithObject:hitModelNode] : [NSSet set]);
 
     // Respond to touch and become first responder.
@@ -707,19 +2318,13 @@
 
 - (void) moveToSiblingByRelativeIndex:(NSInteger)relativeIndex
 {
-    id <PSTreeGraphModelNode> modelNode = self.singleSelectedModelNode;
-    if (modelNode) {
-        id <PSTreeGraphModelNode> sibling = [self siblingOfModelNode:modelNode atRelativeIndex:relativeIndex];
-        if (sibling) {
-            self.selectedModelNodes = [NSSet setWithObject:sibling];
-        }
-    } else if (self.selectedModelNodes.count == 0) {
-        // If nothing selected, select root.
-        self.selectedModelNodes = (self.modelRoot ? [NSSet setWithObject:self.modelRoot] : nil);
+    // Later siblings are laid out above earlier ones in a horizontal tree, and to their left in a
+    // vertical one.  Step that way, one node at a time.
+    BOOL horizontal = ( self.treeGraphOrientation == PSTreeGraphOrientationStyleHorizontal ||
+                        self.treeGraphOrientation == PSTreeGraphOrientationStyleHorizontalFlipped );
+    for (NSInteger step = 0; step < ABS(relativeIndex); ++step) {
+        [self moveAlongY:horizontal forward:(relativeIndex < 0) distance:0.0f];
     }
-
-    // Scroll new selection to visible.
-    [self scrollSelectedModelNodesToVisibleAnimated:YES];
 }
 
 - (IBAction) moveToParent:(id)sender
@@ -727,14 +2332,15 @@
     id <PSTreeGraphModelNode> modelNode = self.singleSelectedModelNode;
     if (modelNode) {
         if (modelNode != self.modelRoot) {
-            id <PSTreeGraphModelNode> parent = [modelNode parentModelNode];
+            // Follow the layout, which for a shared node may differ from its parentModelNode.
+            id <PSTreeGraphModelNode> parent = [self layoutParentOfModelNode:modelNode];
             if (parent) {
                 self.selectedModelNodes = [NSSet setWithObject:parent];
             }
         }
     } else if (self.selectedModelNodes.count == 0) {
         // If nothing selected, select root.
-        self.selectedModelNodes = (self.modelRoot ? [NSSet setWithObject:self.modelRoot] : nil);
+        self.selectedModelNodes = (self.selectableRootModelNode ? [NSSet setWithObject:self.selectableRootModelNode] : nil);
     }
 
     // Scroll new selection to visible.
@@ -764,55 +2370,129 @@
         }
     } else if (self.selectedModelNodes.count == 0) {
         // If nothing selected, select root.
-        self.selectedModelNodes = (self.modelRoot ? [NSSet setWithObject:self.modelRoot] : nil);
+        self.selectedModelNodes = (self.selectableRootModelNode ? [NSSet setWithObject:self.selectableRootModelNode] : nil);
     }
 
     // Scroll new selection to visible.
     [self scrollSelectedModelNodesToVisibleAnimated:YES];
 }
 
-- (void) moveUp:(id)sender
+- (void) navigateToModelNode:(id <PSTreeGraphModelNode> )modelNode
 {
-    if (( self.treeGraphOrientation == PSTreeGraphOrientationStyleHorizontal ) ||
-        ( self.treeGraphOrientation == PSTreeGraphOrientationStyleHorizontalFlipped )){
-        [self moveToSiblingByRelativeIndex:1];
-    } else {
-        [self moveToParent:sender];
+    if (modelNode == nil) {
+        return;
     }
 
+    // Key repeat can deliver several moves per frame.  Remember only where they lead, and select
+    // and scroll once, on the next frame.
+    _pendingNavigationModelNode = modelNode;
+    ++_pendingNavigationMoveCount;
+
+    if (_navigationDisplayLink == nil) {
+        _navigationDisplayLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(applyPendingNavigation:)];
+        [_navigationDisplayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+    }
 }
 
-- (void) moveDown:(id)sender
+- (void) applyPendingNavigation:(CADisplayLink *)displayLink
 {
-    if (( self.treeGraphOrientation == PSTreeGraphOrientationStyleHorizontal ) ||
-        ( self.treeGraphOrientation == PSTreeGraphOrientationStyleHorizontalFlipped )){
-        [self moveToSiblingByRelativeIndex:-1];
-    } else {
-        [self moveToNearestChild:sender];
-    }
+    [self applyPendingNavigationIfNeeded];
+}
+
+- (void) applyPendingNavigationIfNeeded
+{
+    // One shot.  (The display link retains us, so don't keep it running.)
+    [_navigationDisplayLink invalidate];
+    _navigationDisplayLink = nil;
+
+    id <PSTreeGraphModelNode> modelNode = _pendingNavigationModelNode;
+    NSUInteger moveCount = _pendingNavigationMoveCount;
+    _pendingNavigationModelNode = nil;
+    _pendingNavigationMoveCount = 0;
+
+    if (modelNode && [self modelNodeIsInAssignedTree:modelNode]) {
+        self.selectedModelNodes = [NSSet setWithObject:modelNode];
 
+        // Animating every frame of a held key would only restart the animation each time.
+        [self scrollSelectedModelNodesToVisibleAnimated:(moveCount == 1)];
+    }
 }
 
-- (void) moveLeft:(id)sender
+- (void) moveAlongY:(BOOL)alongY forward:(BOOL)forward distance:(CGFloat)distance
 {
-    if (( self.treeGraphOrientation == PSTreeGraphOrientationStyleHorizontal ) ||
-        ( self.treeGraphOrientation == PSTreeGraphOrientationStyleHorizontalFlipped )){
-        [self moveToParent:sender];
-    } else {
-        [self moveToSiblingByRelativeIndex:1];
+    // Moves made since the last frame haven't been applied yet, so carry on from where they lead.
+    id <PSTreeGraphModelNode> modelNode = _pendingNavigationModelNode ? _pendingNavigationModelNode : self.singleSelectedModelNode;
+    if (modelNode) {
+        [self navigateToModelNode:[self modelNodeNearestToModelNode:modelNode
+                                                             alongY:alongY
+                                                            forward:forward
+                                                           distance:distance]];
+    } else if (self.selectedModelNodes.count == 0) {
+        // If nothing selected, select root.
+        [self navigateToModelNode:self.selectableRootModelNode];
     }
+}
+
+- (void) moveUp:(id)sender
+{
+    [self moveAlongY:YES forward:NO distance:0.0f];
+}
+
+- (void) moveDown:(id)sender
+{
+    [self moveAlongY:YES forward:YES distance:0.0f];
+}
 
+- (void) moveLeft:(id)sender
+{
+    [self moveAlongY:NO forward:NO distance:0.0f];
 }
 
 - (void) moveRight:(id)sender
 {
-    if (( self.treeGraphOrientation == PSTreeGraphOrientationStyleHorizontal ) ||
-        ( self.treeGraphOrientation == PSTreeGraphOrientationStyleHorizontalFlipped )){
-        [self moveToNearestChild:sender];
-    } else {
-        [self moveToSiblingByRelativeIndex:-1];
+    [self moveAlongY:NO forward:YES distance:0.0f];
+}
+
+- (IBAction) pageUp:(id)sender
+{
+    [self moveAlongY:YES forward:NO distance:CGRectGetHeight([self visibleGraphRect])];
+}
+
+- (IBAction) pageDown:(id)sender
+{
+    [self moveAlongY:YES forward:YES distance:CGRectGetHeight([self visibleGraphRect])];
+}
+
+- (IBAction) moveToBeginningOfDocument:(id)sender
+{
+    [self navigateToModelNode:self.selectableRootModelNode];
+}
+
+- (IBAction) moveToEndOfDocument:(id)sender
+{
+    // The last visible node, in tree order.
+    [self updateNavigationIndexIfNeeded];
+    [self navigateToModelNode:_navigationModelNodes.lastObject];
+}
+
+
+#pragma mark UIKeyCommand Support
+
+- (NSArray *) keyCommands
+{
+    // UIKeyCommand is only available from iOS 7.
+    if ( ![UIKeyCommand class] ) {
+        return nil;
     }
 
+    return @[ [UIKeyCommand keyCommandWithInput:UIKeyInputUpArrow modifierFlags:0 action:@selector(moveUp:)],
+              [UIKeyCommand keyCommandWithInput:UIKeyInputDownArrow modifierFlags:0 action:@selector(moveDown:)],
+              [UIKeyCommand keyCommandWithInput:UIKeyInputLeftArrow modifierFlags:0 action:@selector(moveLeft:)],
+              [UIKeyCommand keyCommandWithInput:UIKeyInputRightArrow modifierFlags:0 action:@selector(moveRight:)],
+              [UIKeyCommand keyCommandWithInput:UIKeyInputUpArrow modifierFlags:UIKeyModifierAlternate action:@selector(pageUp:)],
+              [UIKeyCommand keyCommandWithInput:UIKeyInputDownArrow modifierFlags:UIKeyModifierAlternate action:@selector(pageDown:)],
+              [UIKeyCommand keyCommandWithInput:UIKeyInputUpArrow modifierFlags:UIKeyModifierCommand action:@selector(moveToBeginningOfDocument:)],
+              [UIKeyCommand keyCommandWithInput:UIKeyInputDownArrow modifierFlags:UIKeyModifierCommand action:@selector(moveToEndOfDocument:)] ];
 }
 
 
@@ -830,37 +2510,45 @@
 {
     // Hardware keyboard, desktop keyboard in simulator support.
     if (theText && theText.length > 0) {
+
+        // While a search string is being typed, every key edits the search.
+        if (_typingSearchString) {
+            [self insertSearchText:theText];
+            return;
+        }
+
         switch ([theText characterAtIndex:0]) {
+            case '/':
+                _typingSearchString = YES;
+                self.searchString = nil;
+                break;
+            case 'n':
+                [self showNextSearchMatch:self];
+                break;
+            case 'N':
+                [self showPreviousSearchMatch:self];
+                break;
             case ' ':
                 [self toggleExpansionOfSelectedModelNodes:self];
                 break;
+            // Moves are on screen, so they work the same way whichever way the graph is oriented.
             case 'w':
-                if (self.treeGraphOrientation == PSTreeGraphOrientationStyleVerticalFlipped ) {
-                    [self moveDown:self];
-                } else {
-                    [self moveUp:self];
-                }
+                [self moveUp:self];
                 break;
             case 'a':
-                if (self.treeGraphOrientation == PSTreeGraphOrientationStyleHorizontalFlipped ) {
-                    [self moveRight:self];
-                } else {
-                    [self moveLeft:self];
-                }
+                [self moveLeft:self];
                 break;
             case 's':
-                if (self.treeGraphOrientation == PSTreeGraphOrientationStyleVerticalFlipped ) {
-                    [self moveUp:self];
-                } else {
-                    [self moveDown:self];
-                }
+                [self moveDown:self];
                 break;
             case 'd':
-                if (self.treeGraphOrientation == PSTreeGraphOrientationStyleHorizontalFlipped ) {
-                    [self moveLeft:self];
-                } else {
-                    [self moveRight:self];
-                }
+                [self moveRight:self];
+                break;
+            case 'W':
+                [self pageUp:self];
+                break;
+            case 'S':
+                [self pageDown:self];
                 break;
 
             default:
@@ -870,8 +2558,38 @@
     }
 }
 
+- (void) insertSearchText:(NSString *)theText
+{
+    switch ([theText characterAtIndex:0]) {
+        case '\n':
+        case '\r':
+            // Stop typing, leaving the matches selected so "n" and "N" can step through them.
+            _typingSearchString = NO;
+            break;
+        case '\t':
+            [self showNextSearchMatch:self];
+            break;
+        default:
+            self.searchString = (self.searchString ? [self.searchString stringByAppendingString:theText] : theText);
+            break;
+    }
+}
+
 - (void) deleteBackward
 {
+    if (_typingSearchString) {
+        NSString *searchString = self.searchString;
+        if (searchString.length > 0) {
+            NSRange lastCharacter = [searchString rangeOfComposedCharacterSequenceAtIndex:searchString.length - 1];
+            self.searchString = [searchString substringToIndex:lastCharacter.location];
+        } else {
+            // Deleting past the start of the search string ends the search.
+            _typingSearchString = NO;
+            self.searchString = nil;
+        }
+        return;
+    }
+
     [self moveLeft:nil];
 }
 
@@ -917,6 +2635,14 @@
 @implementation PSBaseTreeGraphView (Internal)
 
 
+#pragma mark - Drawing Statistics
+
+- (void) noteConnectorPathRebuilt
+{
+    ++_connectorPathRebuildCount;
+}
+
+
 #pragma mark - ModelNode -> SubtreeView Relationship Management
 
 - (PSBaseSubtreeView *) subtreeViewForModelNode:(id)modelNode
@@ -938,12 +2664,15 @@
     NSParameterAssert(modelNode != nil);
     NSParameterAssert(possibleAncestor != nil);
 
-    id <PSTreeGraphModelNode> node = [modelNode parentModelNode];
-    while (node != nil) {
-        if (node == possibleAncestor) {
+    // Walk the displayed graph rather than the model.  A shared node is only displayed under one
+    // of its parents.
+    PSBaseSubtreeView *ancestorSubtreeView = [self subtreeViewForModelNode:possibleAncestor];
+    UIView *view = [self subtreeViewForModelNode:modelNode].superview;
+    while (view != nil && view != self) {
+        if (view == ancestorSubtreeView) {
             return YES;
         }
-        node = [node parentModelNode];
+        view = view.superview;
     }
     return NO;
 }
@@ -952,39 +2681,26 @@
 {
     NSParameterAssert(modelNode != nil);
 
-    id <PSTreeGraphModelNode> root = self.modelRoot;
-    return (modelNode == root || [self modelNode:modelNode isDescendantOf:root]) ? YES : NO;
+    return ([self subtreeViewForModelNode:modelNode] != nil) ? YES : NO;
 }
 
-- (id <PSTreeGraphModelNode> ) siblingOfModelNode:(id <PSTreeGraphModelNode> )modelNode
-                                  atRelativeIndex:(NSInteger)relativeIndex
+- (id <PSTreeGraphModelNode> ) layoutParentOfModelNode:(id <PSTreeGraphModelNode> )modelNode
 {
     NSParameterAssert(modelNode != nil);
-    NSAssert([self modelNodeIsInAssignedTree:modelNode], @"modelNode is not in the tree");
 
-    if (modelNode == self.modelRoot) {
-        // modelNode is modelRoot.  Disallow traversal to its siblings (if it has any).
-        return nil;
-    } else {
-        // modelNode is a descendant of modelRoot.
-        // Find modelNode's position in its parent node's array of children.
-        id <PSTreeGraphModelNode> parent = [modelNode parentModelNode];
-        NSArray *siblings = [parent childModelNodes];
-
-        NSAssert(siblings != nil,
-                 @"childModelNodes should return an empty array ([NSArray array]), not nil.");
-
-        if (siblings != nil) {
-            NSInteger index = [siblings indexOfObject:modelNode];
-            if (index != NSNotFound) {
-                index += relativeIndex;
-                if (index >= 0 && index < siblings.count) {
-                    return siblings[index];
-                }
-            }
-        }
+    UIView *parentView = [self subtreeViewForModelNode:modelNode].superview;
+    if ( ![parentView isKindOfClass:[PSBaseSubtreeView class]] ) {
         return nil;
     }
+
+    // The roots of a forest have no parent the user can select.
+    PSBaseSubtreeView *parentSubtreeView = (PSBaseSubtreeView *)parentView;
+    return parentSubtreeView.isForestRoot ? nil : parentSubtreeView.modelNode;
+}
+
+- (id <PSTreeGraphModelNode> ) selectableRootModelNode
+{
+    return self.modelRoots.firstObject;
 }
 
 
@@ -40,7 +40,8 @@
 
 #pragma mark - Model Tree Navigation
 
-// Returns YES if modelNode is a descendant of possibleAncestor, NO if not.
+// Returns YES if modelNode is a descendant of possibleAncestor in the displayed graph, NO if not.
+// A node shared between several parents is only a descendant of the one it is laid out under.
 //
 // Neither modelNode or possibleAncestor should be nil.
 
@@ -48,6 +49,7 @@
     isDescendantOf:(id <PSTreeGraphModelNode> )possibleAncestor;
 
 // Returns YES if modelNode is the TreeGraph's assigned modelRoot, or a descendant of modelRoot.
+// That is, if it has a SubtreeView.
 //
 // Returns NO if not.  TreeGraph uses this determination to avoid traversing nodes above its
 // assigned modelRoot (if there are any).
@@ -56,20 +58,38 @@
 
 - (BOOL) modelNodeIsInAssignedTree:(id <PSTreeGraphModelNode> )modelNode;
 
-// Returns the sibling at the given offset relative to the given modelNode.
-// (e.g. relativeIndex == -1 requests the previous sibling. relativeIndex == +1 requests the next sibling.)
-//
-// Returns nil if the modelNode has no sibling at the specified relativeIndex (resultant index out of bounds).
-//
-// This method won't go above the subtree defined by the TreeGraph's modelRoot.
-// (That is: If the given modelNode is the TreeGraph's modelRoot, this method returns nil, even if
-// the requested sibling exists.)
-//
-// Checks modelNode is nil, or if modelNode is not within the subtree assigned to the TreeGraph.
-//
+// Returns the model node that modelNode is laid out under, or nil if modelNode is a root.
+
+- (id <PSTreeGraphModelNode> ) layoutParentOfModelNode:(id <PSTreeGraphModelNode> )modelNode;
+
+// Returns the node to select when there is nothing else to go on: the first root.
+
+- (id <PSTreeGraphModelNode> ) selectableRootModelNode;
+
+
+#pragma mark - Keyboard Navigation
+
+// Keyboard moves are applied once per frame, from a display link.  Applies any that are waiting now,
+// for callers that need the selection settled right away.
+
+- (void) applyPendingNavigationIfNeeded;
+
+
+#pragma mark - Drawing Statistics
+
+// Called by a BranchView each time it rebuilds its connecting line geometry.
+
+- (void) noteConnectorPathRebuilt;
+
+
+#pragma mark - Layout Observation
+
+// Working out the rect that changed in a layout costs a pass over everything laid out, so it's only
+// done, and reported under PSTreeGraphViewChangedRectKey, between these calls.  Calls nest, and must
+// be balanced.  A minimap calls them as it attaches to, and detaches from, the TreeGraph.
 
-- (id<PSTreeGraphModelNode>) siblingOfModelNode:(id <PSTreeGraphModelNode> )modelNode
-                                atRelativeIndex:(NSInteger)relativeIndex;
+- (void) beginReportingChangedRects;
+- (void) endReportingChangedRects;
 
 
 #pragma mark - Node View Nib Caching
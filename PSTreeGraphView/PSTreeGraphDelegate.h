@@ -18,6 +18,8 @@
 
 @protocol PSTreeGraphModelNode;
 
+@class PSBaseTreeGraphView;
+
 
 @protocol PSTreeGraphDelegate <NSObject>
 
@@ -27,4 +29,38 @@
 
 - (void) configureNodeView:(UIView *)nodeView withModelNode:(id <PSTreeGraphModelNode> )modelNode;
 
+@optional
+
+/// The delegate will return the text a user would search for to find the modelNode, usually the
+/// same text it shows in the node view.  Implementing this method enables searching the TreeGraph.
+///
+/// @note This is called from a background queue while the search index is built, so it must not
+/// touch any views.
+
+- (NSString *) labelForModelNode:(id <PSTreeGraphModelNode> )modelNode;
+
+
+#pragma mark - Prefetching
+
+/// The TreeGraph is about to show the modelNodes, and will soon ask for their node views to be configured.
+/// The delegate should start loading whatever content the node views need (images, rich text, queries
+/// against a store) asynchronously, so it is ready by the time -configureNodeView:withModelNode: is called.
+///
+/// Implementing this method enables prefetching.  When prefetching, the TreeGraph no longer calls
+/// -configureNodeView:withModelNode: for every node while it builds its view tree.  Each node view is given
+/// placeholder content first, and is configured asynchronously, on the main queue, once it scrolls into
+/// view.  Call -parentClipViewDidScroll: as the enclosing UIScrollView scrolls to keep this up to date.
+
+- (void) treeGraph:(PSBaseTreeGraphView *)treeGraph prefetchContentForModelNodes:(NSArray *)modelNodes;
+
+/// The modelNodes previously passed to -treeGraph:prefetchContentForModelNodes: have scrolled away
+/// before being shown.  The delegate may cancel loading their content.
+
+- (void) treeGraph:(PSBaseTreeGraphView *)treeGraph cancelPrefetchingContentForModelNodes:(NSArray *)modelNodes;
+
+/// When prefetching, the delegate will configure the nodeView with cheap placeholder content for the
+/// modelNode.  This is called while the view tree is built, in place of -configureNodeView:withModelNode:.
+
+- (void) configurePlaceholderNodeView:(UIView *)nodeView withModelNode:(id <PSTreeGraphModelNode> )modelNode;
+
 @end
\ No newline at end of file
@@ -0,0 +1,100 @@
+//
+//  PSTreeGraphLayoutCache.h
+//  PSTreeGraphView
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+//
+//  This is a port of the sample code from Max OS X to iOS (iPad).
+//
+//  WWDC 2010 Session 141, “Crafting Custom Cocoa Views”
+//
+
+
+#import <UIKit/UIKit.h>
+
+
+@class PSBaseTreeGraphView;
+
+
+/// Flags stored with each cached SubtreeView layout record.
+
+typedef NS_OPTIONS(uint32_t, PSTreeGraphLayoutRecordFlags) {
+    PSTreeGraphLayoutRecordFlagExpanded = 1 << 0,
+    PSTreeGraphLayoutRecordFlagHidden = 1 << 1,
+    PSTreeGraphLayoutRecordFlagConnectorsHidden = 1 << 2,
+};
+
+
+/// The fixed size record stored for each SubtreeView, in pre-order.  Frames are stored
+/// as {x, y, width, height} in the coordinate space of the view's superview.
+
+typedef struct PSTreeGraphLayoutRecord {
+    uint64_t nodeIdentifier;
+    uint32_t flags;
+    uint32_t reserved;
+    float    frame[4];
+    float    nodeViewFrame[4];
+    float    connectorsFrame[4];
+} PSTreeGraphLayoutRecord;
+
+
+/// A compact, versioned binary snapshot of a TreeGraph's layout: node identifiers, expansion
+/// state, measured node sizes and computed positions.  The snapshot is keyed by a fingerprint
+/// of the model root and the layout metrics, and is memory-mapped when loaded, so a previously
+/// viewed tree can be shown in its last state without being laid out again.
+///
+/// @note Records are matched to model nodes by -modelNodeIdentifier.  Nothing is written or
+/// restored unless every model node in the tree implements it, and returns a non-nil identifier.
+///
+/// @note Validation is eager.  A snapshot is only applied to a fully built view tree (a SubtreeView,
+/// and a nodeView from the nib, for every model node), and every record is checked against its model
+/// node, hashing each identifier, before anything is applied.  What a warm start saves is the layout
+/// pass itself (measuring, positioning and flipping every SubtreeView), not the tree build, and it
+/// costs one extra walk of the tree.
+
+@interface PSTreeGraphLayoutCache : NSObject
+
+/// Maps the cache file at the given URL.  Returns nil if the file does not exist, or is not a
+/// layout cache of the current version.
+
+- (instancetype) initWithContentsOfURL:(NSURL *)url NS_DESIGNATED_INITIALIZER;
+
+// Don't initialise with this:
+- (instancetype) init NS_UNAVAILABLE;
+
+/// The fingerprint the snapshot was recorded under.
+
+@property (nonatomic, readonly) uint64_t fingerprint;
+
+/// The number of SubtreeView records in the snapshot.
+
+@property (nonatomic, readonly) NSUInteger recordCount;
+
+/// Returns the fingerprint for the treeGraph's current modelRoot and layout metrics.  A snapshot
+/// can only be applied to a TreeGraph with a matching fingerprint.
+
++ (uint64_t) fingerprintForTreeGraph:(PSBaseTreeGraphView *)treeGraph;
+
+/// Returns YES if every model node shown by the treeGraph has a -modelNodeIdentifier, so its
+/// layout can be written and restored.
+
++ (BOOL) canCacheLayoutOfTreeGraph:(PSBaseTreeGraphView *)treeGraph;
+
+/// Writes a snapshot of the treeGraph's current layout to the given URL.  The treeGraph should
+/// not need layout.  Returns NO and sets error if the file could not be written, or if the model
+/// nodes have no identifiers (see +canCacheLayoutOfTreeGraph:).
+
++ (BOOL) writeLayoutOfTreeGraph:(PSBaseTreeGraphView *)treeGraph
+                          toURL:(NSURL *)url
+                          error:(NSError **)error;
+
+/// Validates the snapshot against the treeGraph's live view tree and, if every record matches
+/// its model node and the size of its nodeView, restores the expansion state and layout of each
+/// SubtreeView without relayout.  Returns NO, leaving the treeGraph untouched, if the snapshot
+/// does not match.
+
+- (BOOL) applyToTreeGraph:(PSBaseTreeGraphView *)treeGraph;
+
+@end
@@ -0,0 +1,316 @@
+//
+//  PSTreeGraphLayoutCache.m
+//  PSTreeGraphView
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+//
+//  This is a port of the sample code from Max OS X to iOS (iPad).
+//
+//  WWDC 2010 Session 141, “Crafting Custom Cocoa Views”
+//
+
+
+#import "PSTreeGraphLayoutCache.h"
+#import "PSBaseTreeGraphView.h"
+#import "PSBaseSubtreeView.h"
+
+#import "PSTreeGraphModelNode.h"
+
+
+// Bump the version whenever the header or record layout changes.  Files written with any
+// other version are ignored, and the tree is laid out from scratch.
+
+static const uint32_t PSTreeGraphLayoutCacheMagic = 'PSLC';
+static const uint16_t PSTreeGraphLayoutCacheVersion = 1;
+
+// Records are written in host byte order.  The file is a local cache, not an interchange format.
+
+typedef struct PSTreeGraphLayoutCacheHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint64_t fingerprint;
+    uint64_t recordCount;
+} PSTreeGraphLayoutCacheHeader;
+
+
+#pragma mark - Hashing
+
+// 64 bit FNV-1a.  Cheap, stable across launches, and good enough to key a cache.
+
+static const uint64_t FNVOffsetBasis = 14695981039346656037ULL;
+static const uint64_t FNVPrime = 1099511628211ULL;
+
+static uint64_t FNVHashBytes(uint64_t hash, const void *bytes, size_t length)
+{
+    const uint8_t *p = bytes;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= p[i];
+        hash *= FNVPrime;
+    }
+    return hash;
+}
+
+static uint64_t FNVHashString(uint64_t hash, NSString *string)
+{
+    const char *utf8 = string.UTF8String;
+    return utf8 ? FNVHashBytes(hash, utf8, strlen(utf8)) : hash;
+}
+
+// Returns NO for a model node without a stable identifier.  (Falling back to -description would
+// include the object's address, so the cache would never validate.)
+
+static BOOL GetIdentifierForModelNode(id <PSTreeGraphModelNode> modelNode, uint64_t *identifier)
+{
+    if (![modelNode respondsToSelector:@selector(modelNodeIdentifier)]) {
+        return NO;
+    }
+    NSString *string = [modelNode modelNodeIdentifier];
+    if (string == nil) {
+        return NO;
+    }
+    *identifier = FNVHashString(FNVOffsetBasis, string);
+    return YES;
+}
+
+
+#pragma mark - Internal Interface
+
+@interface PSTreeGraphLayoutCache ()
+{
+
+@private
+
+    // The mapped cache file.
+    NSData *_data;
+}
+
+@end
+
+
+@implementation PSTreeGraphLayoutCache
+
+
+#pragma mark - Instance Initialization
+
+- (instancetype) init { @throw nil; }
+
+- (instancetype) initWithContentsOfURL:(NSURL *)url
+{
+    NSParameterAssert(url != nil);
+
+    self = [super init];
+    if (self) {
+
+        // Map rather than read the file.  Pages are only touched as records are validated and applied.
+        NSData *data = [NSData dataWithContentsOfURL:url options:NSDataReadingMappedAlways error:NULL];
+        if (data.length < sizeof(PSTreeGraphLayoutCacheHeader)) {
+            return nil;
+        }
+
+        const PSTreeGraphLayoutCacheHeader *header = data.bytes;
+        if (header->magic != PSTreeGraphLayoutCacheMagic ||
+            header->version != PSTreeGraphLayoutCacheVersion ||
+            header->recordSize != sizeof(PSTreeGraphLayoutRecord)) {
+            return nil;
+        }
+
+        if ((data.length - sizeof(PSTreeGraphLayoutCacheHeader)) / sizeof(PSTreeGraphLayoutRecord) < header->recordCount) {
+            // Truncated file.
+            return nil;
+        }
+
+        _data = data;
+        _fingerprint = header->fingerprint;
+        _recordCount = (NSUInteger)header->recordCount;
+    }
+    return self;
+}
+
+- (const PSTreeGraphLayoutRecord *) records
+{
+    return (const PSTreeGraphLayoutRecord *)((const uint8_t *)_data.bytes + sizeof(PSTreeGraphLayoutCacheHeader));
+}
+
+
+#pragma mark - Fingerprint
+
++ (uint64_t) fingerprintForTreeGraph:(PSBaseTreeGraphView *)treeGraph
+{
+    // The fingerprint only covers what can be checked without walking the model.  Each record is
+    // validated against its model node when the snapshot is applied.
+
+    uint64_t hash = FNVOffsetBasis;
+
+    id <PSTreeGraphModelNode> root = treeGraph.modelRoot;
+    uint64_t rootIdentifier = 0;
+    if (root && GetIdentifierForModelNode(root, &rootIdentifier)) {
+        hash = FNVHashBytes(hash, &rootIdentifier, sizeof(rootIdentifier));
+    }
+    hash = FNVHashString(hash, treeGraph.nodeViewNibName);
+
+    uint32_t orientation = (uint32_t)treeGraph.treeGraphOrientation;
+    float metrics[2] = { treeGraph.parentChildSpacing, treeGraph.siblingSpacing };
+    hash = FNVHashBytes(hash, &orientation, sizeof(orientation));
+    hash = FNVHashBytes(hash, metrics, sizeof(metrics));
+
+    return hash;
+}
+
+
+#pragma mark - Writing
+
+static BOOL SubtreeHasIdentifiers(PSBaseSubtreeView *subtreeView)
+{
+    uint64_t identifier;
+    if (!GetIdentifierForModelNode(subtreeView.modelNode, &identifier)) {
+        return NO;
+    }
+
+    for (UIView *subview in subtreeView.subviews) {
+        if ([subview isKindOfClass:[PSBaseSubtreeView class]]) {
+            if (!SubtreeHasIdentifiers((PSBaseSubtreeView *)subview)) {
+                return NO;
+            }
+        }
+    }
+    return YES;
+}
+
++ (BOOL) canCacheLayoutOfTreeGraph:(PSBaseTreeGraphView *)treeGraph
+{
+    PSBaseSubtreeView *rootSubtreeView = treeGraph.rootSubtreeView;
+    return (rootSubtreeView != nil && SubtreeHasIdentifiers(rootSubtreeView)) ? YES : NO;
+}
+
+static void AppendRecords(PSBaseSubtreeView *subtreeView, NSMutableData *data)
+{
+    PSTreeGraphLayoutRecord record;
+    memset(&record, 0, sizeof(record));
+    GetIdentifierForModelNode(subtreeView.modelNode, &record.nodeIdentifier);
+
+    [subtreeView getLayoutRecord:&record];
+    [data appendBytes:&record length:sizeof(record)];
+
+    for (UIView *subview in subtreeView.subviews) {
+        if ([subview isKindOfClass:[PSBaseSubtreeView class]]) {
+            AppendRecords((PSBaseSubtreeView *)subview, data);
+        }
+    }
+}
+
++ (BOOL) writeLayoutOfTreeGraph:(PSBaseTreeGraphView *)treeGraph
+                          toURL:(NSURL *)url
+                          error:(NSError **)error
+{
+    NSParameterAssert(treeGraph != nil);
+    NSParameterAssert(url != nil);
+
+    if (![self canCacheLayoutOfTreeGraph:treeGraph]) {
+        if (error) {
+            *error = [NSError errorWithDomain:NSCocoaErrorDomain
+                                         code:NSFeatureUnsupportedError
+                                     userInfo:@{ NSLocalizedDescriptionKey :
+                                                     @"The model nodes do not implement modelNodeIdentifier." }];
+        }
+        return NO;
+    }
+
+    PSBaseSubtreeView *rootSubtreeView = treeGraph.rootSubtreeView;
+
+    PSTreeGraphLayoutCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = PSTreeGraphLayoutCacheMagic;
+    header.version = PSTreeGraphLayoutCacheVersion;
+    header.recordSize = sizeof(PSTreeGraphLayoutRecord);
+    header.fingerprint = [self fingerprintForTreeGraph:treeGraph];
+
+    NSMutableData *data = [NSMutableData dataWithBytes:&header length:sizeof(header)];
+    if (rootSubtreeView) {
+        AppendRecords(rootSubtreeView, data);
+    }
+
+    // Patch in the record count now that we know it.
+    PSTreeGraphLayoutCacheHeader *writtenHeader = data.mutableBytes;
+    writtenHeader->recordCount = (data.length - sizeof(header)) / sizeof(PSTreeGraphLayoutRecord);
+
+    return [data writeToURL:url options:NSDataWritingAtomic error:error];
+}
+
+
+#pragma mark - Reading
+
+static BOOL ValidateRecords(PSBaseSubtreeView *subtreeView,
+                            const PSTreeGraphLayoutRecord *records,
+                            NSUInteger count,
+                            NSUInteger *index)
+{
+    if (*index >= count) {
+        return NO;
+    }
+
+    const PSTreeGraphLayoutRecord *record = &records[*index];
+    uint64_t identifier;
+    if (!GetIdentifierForModelNode(subtreeView.modelNode, &identifier) || record->nodeIdentifier != identifier) {
+        return NO;
+    }
+
+    // A changed nib (or node content) means different node sizes, and the recorded positions no
+    // longer fit.  Never force the old sizes back onto the live nodeViews.
+    CGSize nodeViewSize = subtreeView.nodeView.bounds.size;
+    if (record->nodeViewFrame[2] != (float)nodeViewSize.width ||
+        record->nodeViewFrame[3] != (float)nodeViewSize.height) {
+        return NO;
+    }
+    ++(*index);
+
+    for (UIView *subview in subtreeView.subviews) {
+        if ([subview isKindOfClass:[PSBaseSubtreeView class]]) {
+            if (!ValidateRecords((PSBaseSubtreeView *)subview, records, count, index)) {
+                return NO;
+            }
+        }
+    }
+    return YES;
+}
+
+static void ApplyRecords(PSBaseSubtreeView *subtreeView,
+                         const PSTreeGraphLayoutRecord *records,
+                         NSUInteger *index)
+{
+    [subtreeView applyLayoutRecord:&records[*index]];
+    ++(*index);
+
+    for (UIView *subview in subtreeView.subviews) {
+        if ([subview isKindOfClass:[PSBaseSubtreeView class]]) {
+            ApplyRecords((PSBaseSubtreeView *)subview, records, index);
+        }
+    }
+}
+
+- (BOOL) applyToTreeGraph:(PSBaseTreeGraphView *)treeGraph
+{
+    NSParameterAssert(treeGraph != nil);
+
+    PSBaseSubtreeView *rootSubtreeView = treeGraph.rootSubtreeView;
+    if (rootSubtreeView == nil || self.fingerprint != [[self class] fingerprintForTreeGraph:treeGraph]) {
+        return NO;
+    }
+
+    // Validate every record before touching any view, so a stale snapshot leaves the tree as built.
+    const PSTreeGraphLayoutRecord *records = [self records];
+    NSUInteger index = 0;
+    if (!ValidateRecords(rootSubtreeView, records, self.recordCount, &index) || index != self.recordCount) {
+        return NO;
+    }
+
+    index = 0;
+    ApplyRecords(rootSubtreeView, records, &index);
+
+    return YES;
+}
+
+
+@end
@@ -0,0 +1,58 @@
+//
+//  PSTreeGraphMinimapView.h
+//  PSTreeGraphView
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+//
+//  This is a port of the sample code from Max OS X to iOS (iPad).
+//
+//  WWDC 2010 Session 141, “Crafting Custom Cocoa Views”
+//
+
+
+#import <UIKit/UIKit.h>
+
+
+@class PSBaseTreeGraphView;
+
+
+/// A small overview of an entire TreeGraph, showing where its enclosing UIScrollView is currently
+/// looking.  Tap or drag in the minimap to scroll the TreeGraph there.
+///
+/// The minimap creates no views of its own for the tree.  It reads the TreeGraph's layout, draws
+/// each node as a rect and each connection as a line into a single cached bitmap, and shows the
+/// viewport as a separate layer on top.  Scrolling only moves the viewport layer.  The bitmap is
+/// rebuilt, at most once per run loop, after the TreeGraph posts PSTreeGraphViewDidLayoutNotification.
+///
+/// Subtrees that would be smaller than a couple of points in the minimap are drawn as a single rect,
+/// as are the children of a node with more children than the minimap has room to show, so the cost of
+/// a rebuild depends on the size of the minimap, not the number of nodes in the tree.  A layout that
+/// leaves the TreeGraph's size unchanged only redraws the part of the bitmap that changed.
+
+@interface PSTreeGraphMinimapView : UIView
+
+/// The TreeGraph to show.  It should be the documentView of a UIScrollView for the viewport and
+/// scrolling to work.
+
+@property (nonatomic, weak) IBOutlet PSBaseTreeGraphView *treeGraph;
+
+/// The fill color for nodes.
+
+@property (nonatomic, strong) UIColor *nodeColor;
+
+/// The stroke color for the lines between nodes.
+
+@property (nonatomic, strong) UIColor *connectingLineColor;
+
+/// The color of the rect showing the visible part of the TreeGraph.
+
+@property (nonatomic, strong) UIColor *viewportColor;
+
+/// Marks the cached bitmap as stale.  It is rebuilt the next time the minimap lays out.  There is
+/// usually no need to call this, the minimap observes the TreeGraph's layout.
+
+- (void) setNeedsTreeUpdate;
+
+@end
@@ -0,0 +1,611 @@
+//
+//  PSTreeGraphMinimapView.m
+//  PSTreeGraphView
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+//
+//  This is a port of the sample code from Max OS X to iOS (iPad).
+//
+//  WWDC 2010 Session 141, “Crafting Custom Cocoa Views”
+//
+
+
+#import "PSTreeGraphMinimapView.h"
+#import "PSBaseTreeGraphView.h"
+#import "PSBaseTreeGraphView_Internal.h"
+#import "PSBaseSubtreeView.h"
+
+#import <QuartzCore/QuartzCore.h>
+
+
+// A subtree whose frame is smaller than this, in minimap points, is drawn as a single rect.
+
+static const CGFloat PSTreeGraphMinimapDetailThreshold = 2.0;
+
+static void *PSTreeGraphMinimapObservationContext = &PSTreeGraphMinimapObservationContext;
+
+
+#pragma mark - Internal Interface
+
+@interface PSTreeGraphMinimapView ()
+{
+
+@private
+
+    // The cached bitmap of the tree, and the viewport drawn over it.  The bitmap context is kept, so
+    // a layout that changes only part of the tree only redraws that part.
+    CALayer *_treeLayer;
+    CALayer *_viewportLayer;
+    CGContextRef _treeContext;
+    CGSize _treeContextSize;
+    BOOL _needsTreeUpdate;
+
+    // The part of the TreeGraph, in its coordinates, that has changed since the bitmap was drawn.
+    CGRect _dirtyGraphRect;
+
+    // Mapping from TreeGraph coordinates to ours: minimap = graph * _scale + _offset.
+    CGFloat _scale;
+    CGPoint _offset;
+
+    // The scroll view whose contentOffset we observe.
+    UIScrollView *_observedScrollView;
+
+    // Geometry collected from the TreeGraph's layout, kept between rebuilds to avoid reallocating.
+    BOOL _horizontalLayout;
+    CGRect *_nodeRects;
+    size_t _nodeRectCount;
+    size_t _nodeRectCapacity;
+    CGPoint *_linePoints;
+    size_t _linePointCount;
+    size_t _linePointCapacity;
+}
+
+@end
+
+
+@implementation PSTreeGraphMinimapView
+
+
+#pragma mark - Initialization
+
+- (void) configureDefaults
+{
+    self.backgroundColor = [UIColor whiteColor];
+    self.clipsToBounds = YES;
+
+    _nodeColor = [UIColor darkGrayColor];
+    _connectingLineColor = [UIColor lightGrayColor];
+    _viewportColor = [UIColor colorWithRed:0.20 green:0.45 blue:0.90 alpha:1.0];
+
+    _scale = 0.0;
+    _offset = CGPointZero;
+    _needsTreeUpdate = YES;
+    _dirtyGraphRect = CGRectNull;
+
+    _treeLayer = [CALayer layer];
+    _treeLayer.actions = @{ @"contents" : [NSNull null], @"bounds" : [NSNull null], @"position" : [NSNull null] };
+    [self.layer addSublayer:_treeLayer];
+
+    _viewportLayer = [CALayer layer];
+    _viewportLayer.actions = @{ @"bounds" : [NSNull null], @"position" : [NSNull null], @"hidden" : [NSNull null] };
+    _viewportLayer.borderWidth = 1.5;
+    _viewportLayer.borderColor = _viewportColor.CGColor;
+    _viewportLayer.backgroundColor = [_viewportColor colorWithAlphaComponent:0.15].CGColor;
+    _viewportLayer.hidden = YES;
+    [self.layer addSublayer:_viewportLayer];
+}
+
+- (instancetype) initWithFrame:(CGRect)frame
+{
+    self = [super initWithFrame:frame];
+    if (self) {
+        [self configureDefaults];
+    }
+    return self;
+}
+
+- (instancetype) initWithCoder:(NSCoder *)decoder
+{
+    self = [super initWithCoder:decoder];
+    if (self) {
+        [self configureDefaults];
+    }
+    return self;
+}
+
+
+#pragma mark - Resource Management
+
+- (void) dealloc
+{
+    [self stopObservingTreeGraph:_treeGraph];
+
+    free(_nodeRects);
+    free(_linePoints);
+    CGContextRelease(_treeContext);
+}
+
+
+#pragma mark - Styling
+
+- (void) setNodeColor:(UIColor *)newNodeColor
+{
+    if (_nodeColor != newNodeColor) {
+        _nodeColor = newNodeColor;
+        [self setNeedsTreeUpdate];
+    }
+}
+
+- (void) setConnectingLineColor:(UIColor *)newConnectingLineColor
+{
+    if (_connectingLineColor != newConnectingLineColor) {
+        _connectingLineColor = newConnectingLineColor;
+        [self setNeedsTreeUpdate];
+    }
+}
+
+- (void) setViewportColor:(UIColor *)newViewportColor
+{
+    if (_viewportColor != newViewportColor) {
+        _viewportColor = newViewportColor;
+        _viewportLayer.borderColor = _viewportColor.CGColor;
+        _viewportLayer.backgroundColor = [_viewportColor colorWithAlphaComponent:0.15].CGColor;
+    }
+}
+
+
+#pragma mark - TreeGraph Observation
+
+- (UIScrollView *) enclosingScrollViewOfTreeGraph:(PSBaseTreeGraphView *)treeGraph
+{
+    UIScrollView *enclosingScrollView = (UIScrollView *)treeGraph.superview;
+    if ( enclosingScrollView && [enclosingScrollView isKindOfClass:[UIScrollView class]] ) {
+        return enclosingScrollView;
+    }
+    return nil;
+}
+
+- (void) observeScrollViewOfTreeGraph:(PSBaseTreeGraphView *)treeGraph
+{
+    // The TreeGraph may have been moved to a different scroll view since we last looked.
+    UIScrollView *scrollView = [self enclosingScrollViewOfTreeGraph:treeGraph];
+    if (_observedScrollView != scrollView) {
+        [_observedScrollView removeObserver:self
+                                 forKeyPath:@"contentOffset"
+                                    context:PSTreeGraphMinimapObservationContext];
+        _observedScrollView = scrollView;
+        [_observedScrollView addObserver:self
+                              forKeyPath:@"contentOffset"
+                                 options:0
+                                 context:PSTreeGraphMinimapObservationContext];
+    }
+}
+
+- (void) stopObservingTreeGraph:(PSBaseTreeGraphView *)treeGraph
+{
+    if (treeGraph) {
+        [[NSNotificationCenter defaultCenter] removeObserver:self
+                                                        name:PSTreeGraphViewDidLayoutNotification
+                                                      object:treeGraph];
+        [treeGraph endReportingChangedRects];
+    }
+
+    [_observedScrollView removeObserver:self
+                             forKeyPath:@"contentOffset"
+                                context:PSTreeGraphMinimapObservationContext];
+    _observedScrollView = nil;
+}
+
+- (void) setTreeGraph:(PSBaseTreeGraphView *)newTreeGraph
+{
+    if (_treeGraph != newTreeGraph) {
+        [self stopObservingTreeGraph:_treeGraph];
+
+        _treeGraph = newTreeGraph;
+
+        if (_treeGraph) {
+            [[NSNotificationCenter defaultCenter] addObserver:self
+                                                     selector:@selector(treeGraphDidLayout:)
+                                                         name:PSTreeGraphViewDidLayoutNotification
+                                                       object:_treeGraph];
+            [_treeGraph beginReportingChangedRects];
+            [self observeScrollViewOfTreeGraph:_treeGraph];
+        }
+
+        [self setNeedsTreeUpdate];
+    }
+}
+
+- (void) treeGraphDidLayout:(NSNotification *)notification
+{
+    [self observeScrollViewOfTreeGraph:self.treeGraph];
+
+    // Redraw only what changed, if the TreeGraph tells us.
+    NSValue *changedRect = notification.userInfo[PSTreeGraphViewChangedRectKey];
+    if (changedRect == nil) {
+        [self setNeedsTreeUpdate];
+    } else if (!CGRectIsNull(changedRect.CGRectValue)) {
+        _dirtyGraphRect = CGRectUnion(_dirtyGraphRect, changedRect.CGRectValue);
+        [self setNeedsLayout];
+    }
+}
+
+- (void) observeValueForKeyPath:(NSString *)keyPath
+                       ofObject:(id)object
+                         change:(NSDictionary *)change
+                        context:(void *)context
+{
+    if (context == PSTreeGraphMinimapObservationContext) {
+        // Scrolling only moves the viewport.  The cached tree bitmap is untouched.
+        [self updateViewport];
+    } else {
+        [super observeValueForKeyPath:keyPath ofObject:object change:change context:context];
+    }
+}
+
+
+#pragma mark - Coordinate Mapping
+
+- (void) updateMapping
+{
+    // Fit the whole TreeGraph in our bounds, preserving its aspect ratio, and center it.
+    CGSize graphSize = self.treeGraph.bounds.size;
+    CGRect bounds = self.bounds;
+
+    if ( graphSize.width <= 0.0 || graphSize.height <= 0.0 ) {
+        _scale = 0.0;
+        _offset = CGPointZero;
+        return;
+    }
+
+    _scale = MIN(bounds.size.width / graphSize.width, bounds.size.height / graphSize.height);
+    _offset = CGPointMake(CGRectGetMinX(bounds) + 0.5 * (bounds.size.width - graphSize.width * _scale),
+                          CGRectGetMinY(bounds) + 0.5 * (bounds.size.height - graphSize.height * _scale));
+}
+
+- (CGRect) minimapRectForGraphRect:(CGRect)rect
+{
+    return CGRectMake(rect.origin.x * _scale + _offset.x,
+                      rect.origin.y * _scale + _offset.y,
+                      rect.size.width * _scale,
+                      rect.size.height * _scale);
+}
+
+- (CGRect) graphRectForMinimapRect:(CGRect)rect
+{
+    return CGRectMake((rect.origin.x - _offset.x) / _scale,
+                      (rect.origin.y - _offset.y) / _scale,
+                      rect.size.width / _scale,
+                      rect.size.height / _scale);
+}
+
+- (CGPoint) graphPointForMinimapPoint:(CGPoint)point
+{
+    return CGPointMake((point.x - _offset.x) / _scale,
+                       (point.y - _offset.y) / _scale);
+}
+
+
+#pragma mark - Geometry Collection (internal)
+
+- (void) addNodeRect:(CGRect)rect
+{
+    if (_nodeRectCount == _nodeRectCapacity) {
+        size_t capacity = MAX(_nodeRectCapacity * 2, (size_t)256);
+        CGRect *nodeRects = realloc(_nodeRects, capacity * sizeof(CGRect));
+        if (nodeRects == NULL) {
+            return;
+        }
+        _nodeRects = nodeRects;
+        _nodeRectCapacity = capacity;
+    }
+    _nodeRects[_nodeRectCount++] = rect;
+}
+
+- (void) addLineFromPoint:(CGPoint)startPoint toPoint:(CGPoint)endPoint
+{
+    if (_linePointCount + 2 > _linePointCapacity) {
+        size_t capacity = MAX(_linePointCapacity * 2, (size_t)512);
+        CGPoint *linePoints = realloc(_linePoints, capacity * sizeof(CGPoint));
+        if (linePoints == NULL) {
+            return;
+        }
+        _linePoints = linePoints;
+        _linePointCapacity = capacity;
+    }
+    _linePoints[_linePointCount++] = startPoint;
+    _linePoints[_linePointCount++] = endPoint;
+}
+
+- (CGRect) childrenRectOfSubtreeFrame:(CGRect)frame nodeFrame:(CGRect)nodeFrame
+{
+    // Children lie beside the node along the depth axis, on whichever side the node isn't.
+    if (_horizontalLayout) {
+        if (CGRectGetMidX(nodeFrame) < CGRectGetMidX(frame)) {
+            return CGRectMake(CGRectGetMaxX(nodeFrame), CGRectGetMinY(frame),
+                              CGRectGetMaxX(frame) - CGRectGetMaxX(nodeFrame), CGRectGetHeight(frame));
+        }
+        return CGRectMake(CGRectGetMinX(frame), CGRectGetMinY(frame),
+                          CGRectGetMinX(nodeFrame) - CGRectGetMinX(frame), CGRectGetHeight(frame));
+    } else {
+        if (CGRectGetMidY(nodeFrame) < CGRectGetMidY(frame)) {
+            return CGRectMake(CGRectGetMinX(frame), CGRectGetMaxY(nodeFrame),
+                              CGRectGetWidth(frame), CGRectGetMaxY(frame) - CGRectGetMaxY(nodeFrame));
+        }
+        return CGRectMake(CGRectGetMinX(frame), CGRectGetMinY(frame),
+                          CGRectGetWidth(frame), CGRectGetMinY(nodeFrame) - CGRectGetMinY(frame));
+    }
+}
+
+- (void) addGeometryOfSubtreeView:(PSBaseSubtreeView *)subtreeView
+                       withOrigin:(CGPoint)parentOrigin
+                      parentPoint:(const CGPoint *)parentPoint
+                           inRect:(CGRect)dirtyRect
+{
+    if (subtreeView.hidden) {
+        return;
+    }
+
+    // Frames are relative to the enclosing SubtreeView.  Accumulate origins instead of converting.
+    CGRect frame = CGRectOffset(subtreeView.frame, parentOrigin.x, parentOrigin.y);
+    CGPoint frameCenter = CGPointMake(CGRectGetMidX(frame), CGRectGetMidY(frame));
+
+    // Outside the part being redrawn.  The line from the parent may still cross it.
+    if ( !CGRectIsNull(dirtyRect) && !CGRectIntersectsRect(frame, dirtyRect) ) {
+        if (parentPoint) {
+            [self addLineFromPoint:*parentPoint toPoint:frameCenter];
+        }
+        return;
+    }
+
+    // Too small to show any detail.  One rect stands in for the whole subtree.
+    if ( frame.size.width * _scale < PSTreeGraphMinimapDetailThreshold &&
+         frame.size.height * _scale < PSTreeGraphMinimapDetailThreshold ) {
+        [self addNodeRect:frame];
+        if (parentPoint) {
+            [self addLineFromPoint:*parentPoint toPoint:frameCenter];
+        }
+        return;
+    }
+
+    CGRect nodeFrame = CGRectOffset(subtreeView.nodeView.frame, frame.origin.x, frame.origin.y);
+    CGPoint nodeCenter = CGPointMake(CGRectGetMidX(nodeFrame), CGRectGetMidY(nodeFrame));
+
+    [self addNodeRect:nodeFrame];
+    if (parentPoint) {
+        [self addLineFromPoint:*parentPoint toPoint:nodeCenter];
+    }
+
+    if (!subtreeView.expanded) {
+        return;
+    }
+
+    // More children than the minimap has room to tell apart.  Rather than visit each of them (and
+    // their descendants), show them as one block.  The node view and connectors are subviews too,
+    // so the count is an overestimate, which only errs on the side of less detail.
+    NSArray *subviews = subtreeView.subviews;
+    CGRect childrenRect = [self childrenRectOfSubtreeFrame:frame nodeFrame:nodeFrame];
+    CGFloat siblingExtent = _horizontalLayout ? CGRectGetHeight(childrenRect) : CGRectGetWidth(childrenRect);
+    if ( siblingExtent * _scale < subviews.count * PSTreeGraphMinimapDetailThreshold ) {
+        if ( !CGRectIsEmpty(childrenRect) ) {
+            [self addNodeRect:childrenRect];
+            [self addLineFromPoint:nodeCenter toPoint:CGPointMake(CGRectGetMidX(childrenRect), CGRectGetMidY(childrenRect))];
+        }
+        return;
+    }
+
+    for (UIView *subview in subviews) {
+        if ([subview isKindOfClass:[PSBaseSubtreeView class]]) {
+            [self addGeometryOfSubtreeView:(PSBaseSubtreeView *)subview
+                                withOrigin:frame.origin
+                               parentPoint:&nodeCenter
+                                    inRect:dirtyRect];
+        }
+    }
+}
+
+
+#pragma mark - Drawing
+
+- (void) setNeedsTreeUpdate
+{
+    _needsTreeUpdate = YES;
+    [self setNeedsLayout];
+}
+
+- (BOOL) prepareTreeContext
+{
+    CGSize imageSize = self.bounds.size;
+    if ( imageSize.width <= 0.0 || imageSize.height <= 0.0 ) {
+        CGContextRelease(_treeContext);
+        _treeContext = NULL;
+        return NO;
+    }
+
+    if (_treeContext == NULL || !CGSizeEqualToSize(_treeContextSize, imageSize)) {
+        CGContextRelease(_treeContext);
+
+        CGFloat contentsScale = self.window ? self.window.screen.scale : [UIScreen mainScreen].scale;
+        size_t pixelsWide = (size_t)ceil(imageSize.width * contentsScale);
+        size_t pixelsHigh = (size_t)ceil(imageSize.height * contentsScale);
+
+        CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+        _treeContext = CGBitmapContextCreate(NULL, pixelsWide, pixelsHigh, 8, 0, colorSpace,
+                                             kCGImageAlphaPremultipliedFirst | kCGBitmapByteOrder32Host);
+        CGColorSpaceRelease(colorSpace);
+        if (_treeContext == NULL) {
+            return NO;
+        }
+
+        // Work in our (UIKit, top-left origin) coordinates from here on.
+        CGContextTranslateCTM(_treeContext, 0.0, pixelsHigh);
+        CGContextScaleCTM(_treeContext, contentsScale, -contentsScale);
+        CGContextTranslateCTM(_treeContext, -CGRectGetMinX(self.bounds), -CGRectGetMinY(self.bounds));
+
+        _treeContextSize = imageSize;
+        _treeLayer.contentsScale = contentsScale;
+    }
+    return YES;
+}
+
+- (void) updateTreeImageInGraphRect:(CGRect)dirtyRect
+{
+    // Redraws the part of the bitmap showing dirtyRect, or all of it if dirtyRect is CGRectNull.
+    if (![self prepareTreeContext]) {
+        _treeLayer.contents = nil;
+        return;
+    }
+
+    _nodeRectCount = 0;
+    _linePointCount = 0;
+
+    PSTreeGraphOrientationStyle orientation = self.treeGraph.treeGraphOrientation;
+    _horizontalLayout = ( orientation == PSTreeGraphOrientationStyleHorizontal ||
+                          orientation == PSTreeGraphOrientationStyleHorizontalFlipped );
+
+    // Clear what we are about to redraw.  Allow a point around it for line widths and antialiasing, and
+    // redraw everything that meets the cleared rect, not just dirtyRect, so nothing in that margin is lost.
+    CGRect clearRect = self.bounds;
+    CGRect redrawRect = CGRectNull;
+    if (!CGRectIsNull(dirtyRect) && _scale > 0.0) {
+        clearRect = CGRectIntegral(CGRectInset([self minimapRectForGraphRect:dirtyRect], -1.0, -1.0));
+        redrawRect = [self graphRectForMinimapRect:clearRect];
+    }
+
+    PSBaseSubtreeView *rootSubtreeView = self.treeGraph.rootSubtreeView;
+    if (rootSubtreeView && _scale > 0.0) {
+        [self addGeometryOfSubtreeView:rootSubtreeView withOrigin:CGPointZero parentPoint:NULL inRect:redrawRect];
+    }
+
+    CGContextRef context = _treeContext;
+    CGContextSaveGState(context);
+
+    if (!CGRectIsNull(redrawRect)) {
+        CGContextClipToRect(context, clearRect);
+    }
+    CGContextClearRect(context, clearRect);
+
+    // Draw in TreeGraph coordinates.  Everything goes in one stroke and one fill.
+    CGContextTranslateCTM(context, _offset.x, _offset.y);
+    CGContextScaleCTM(context, _scale, _scale);
+
+    if (_linePointCount > 0) {
+        CGContextSetStrokeColorWithColor(context, self.connectingLineColor.CGColor);
+        CGContextSetLineWidth(context, 0.5 / _scale);
+        CGContextStrokeLineSegments(context, _linePoints, _linePointCount);
+    }
+
+    if (_nodeRectCount > 0) {
+        CGContextSetFillColorWithColor(context, self.nodeColor.CGColor);
+        CGContextFillRects(context, _nodeRects, _nodeRectCount);
+    }
+
+    CGContextRestoreGState(context);
+
+    CGImageRef image = CGBitmapContextCreateImage(context);
+    _treeLayer.contents = (__bridge id)image;
+    CGImageRelease(image);
+}
+
+- (void) updateViewport
+{
+    UIScrollView *scrollView = _observedScrollView;
+    PSBaseTreeGraphView *treeGraph = self.treeGraph;
+
+    if (scrollView == nil || treeGraph == nil || _scale <= 0.0) {
+        _viewportLayer.hidden = YES;
+        return;
+    }
+
+    CGRect visibleRect = CGRectIntersection(treeGraph.bounds, [treeGraph convertRect:scrollView.bounds fromView:scrollView]);
+    if (CGRectIsEmpty(visibleRect)) {
+        _viewportLayer.hidden = YES;
+        return;
+    }
+
+    _viewportLayer.frame = [self minimapRectForGraphRect:visibleRect];
+    _viewportLayer.hidden = NO;
+}
+
+
+#pragma mark - UIView
+
+- (void) layoutSubviews
+{
+    [super layoutSubviews];
+
+    CGRect bounds = self.bounds;
+    if (!CGRectEqualToRect(_treeLayer.frame, bounds)) {
+        _treeLayer.frame = bounds;
+        _needsTreeUpdate = YES;
+    }
+
+    if (_needsTreeUpdate) {
+        _needsTreeUpdate = NO;
+        _dirtyGraphRect = CGRectNull;
+        [self updateMapping];
+        [self updateTreeImageInGraphRect:CGRectNull];
+    } else if (!CGRectIsNull(_dirtyGraphRect)) {
+        CGRect dirtyRect = _dirtyGraphRect;
+        _dirtyGraphRect = CGRectNull;
+
+        // If the TreeGraph's size changed anyway, everything moved.
+        CGFloat previousScale = _scale;
+        CGPoint previousOffset = _offset;
+        [self updateMapping];
+        if (_scale == previousScale && CGPointEqualToPoint(_offset, previousOffset)) {
+            [self updateTreeImageInGraphRect:dirtyRect];
+        } else {
+            [self updateTreeImageInGraphRect:CGRectNull];
+        }
+    }
+
+    [self updateViewport];
+}
+
+
+#pragma mark - Touch Handling
+
+- (void) scrollTreeGraphToMinimapPoint:(CGPoint)point
+{
+    UIScrollView *scrollView = _observedScrollView;
+    PSBaseTreeGraphView *treeGraph = self.treeGraph;
+    if (scrollView == nil || treeGraph == nil || _scale <= 0.0) {
+        return;
+    }
+
+    // Center the viewport on the touched point, keeping within the scrollable area.
+    CGPoint graphPoint = [self graphPointForMinimapPoint:point];
+    CGPoint contentPoint = [scrollView convertPoint:graphPoint fromView:treeGraph];
+
+    CGSize viewportSize = scrollView.bounds.size;
+    UIEdgeInsets contentInset = scrollView.contentInset;
+    CGSize contentSize = scrollView.contentSize;
+
+    CGFloat minX = -contentInset.left;
+    CGFloat minY = -contentInset.top;
+    CGFloat maxX = MAX(minX, contentSize.width + contentInset.right - viewportSize.width);
+    CGFloat maxY = MAX(minY, contentSize.height + contentInset.bottom - viewportSize.height);
+
+    CGPoint contentOffset = CGPointMake(contentPoint.x - 0.5 * viewportSize.width,
+                                        contentPoint.y - 0.5 * viewportSize.height);
+    contentOffset.x = MAX(minX, MIN(maxX, contentOffset.x));
+    contentOffset.y = MAX(minY, MIN(maxY, contentOffset.y));
+
+    [scrollView setContentOffset:contentOffset animated:NO];
+}
+
+- (void) touchesBegan:(NSSet *)touches withEvent:(UIEvent *)event
+{
+    [self scrollTreeGraphToMinimapPoint:[touches.anyObject locationInView:self]];
+}
+
+- (void) touchesMoved:(NSSet *)touches withEvent:(UIEvent *)event
+{
+    [self scrollTreeGraphToMinimapPoint:[touches.anyObject locationInView:self]];
+}
+
+
+@end
@@ -29,7 +29,22 @@
 ///
 /// @note If the node has no children, this should return an empty array
 /// ([NSArray array]), not nil.
+///
+/// @note When the TreeGraph's delegate implements -labelForModelNode:, this is also called on a
+/// background queue, while the search index is built (as are -isEqual: and -hash).  It must be
+/// safe to call from any thread, and the model must not change while an index is being built.
 
 - (NSArray *) childModelNodes;
 
+@optional
+
+/// @return A string that identifies the model node, and stays the same across application
+/// launches.  Used to validate cached layout.
+///
+/// @note Layout is only cached for trees where every model node implements this, and returns
+/// a non-nil identifier.  There is no fallback (a description usually includes the object's
+/// address, which changes every launch).
+
+- (NSString *) modelNodeIdentifier;
+
 @end
\ No newline at end of file
@@ -0,0 +1,88 @@
+//
+//  PSTreeGraphSearchIndex.h
+//  PSTreeGraphView
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+//
+//  This is a port of the sample code from Max OS X to iOS (iPad).
+//
+//  WWDC 2010 Session 141, “Crafting Custom Cocoa Views”
+//
+
+
+#import <Foundation/Foundation.h>
+
+
+@protocol PSTreeGraphModelNode;
+
+
+/// Returns the label to index for a model node, or nil if the node should not be searchable.
+
+typedef NSString * (^PSTreeGraphLabelProvider)(id <PSTreeGraphModelNode> modelNode);
+
+
+/// An immutable prefix index over the labels of a model tree.  Each label, and each word within
+/// a label, is normalized (case and diacritic insensitive) and kept in sorted order, so that all
+/// the entries sharing a prefix form a single contiguous range that can be found by binary search.
+/// Narrowing a search as characters are typed only ever searches within the previous range.
+///
+/// An index is expensive to build, but safe to build on a background queue, provided the model
+/// and labelProvider can be used from that queue.  Once built it may be queried from any thread.
+
+@interface PSTreeGraphSearchIndex : NSObject
+
+/// Builds an index over modelRoot and all of its descendants.  A node reachable along several
+/// paths is indexed once, in the position it is first reached.  This is the designated initializer.
+
+- (instancetype) initWithModelRoot:(id <PSTreeGraphModelNode> )modelRoot
+                     labelProvider:(PSTreeGraphLabelProvider)labelProvider NS_DESIGNATED_INITIALIZER;
+
+// Don't initialise with this:
+- (instancetype) init NS_UNAVAILABLE;
+
+/// The root of the model tree the index was built for.
+
+@property (nonatomic, readonly, strong) id <PSTreeGraphModelNode> modelRoot;
+
+/// The range covering every entry in the index.  Use as the starting range for a new search.
+
+@property (nonatomic, readonly) NSRange fullRange;
+
+/// Returns the normalized form of a label or search string, as it is stored in, and compared
+/// against, the index.
+
++ (NSString *) normalizedString:(NSString *)string;
+
+/// Returns the range of entries, within range, that begin with the given normalized prefix.  The
+/// returned range has a length of zero if there are no matches.
+
+- (NSRange) rangeOfEntriesWithPrefix:(NSString *)prefix inRange:(NSRange)range;
+
+/// Returns the distinct model nodes for the entries in range, in the order they appear in the tree
+/// (depth first, children in order).  This sorts the whole range, use the methods below to step
+/// through a large range one match at a time.
+
+- (NSArray *) modelNodesInRange:(NSRange)range;
+
+/// Returns the tree order (the position in a depth first walk) of the first model node after treeOrder
+/// with an entry in range, or NSNotFound if there is none.  Pass NSNotFound to find the first in the tree.
+
+- (NSUInteger) treeOrderOfModelNodeInRange:(NSRange)range following:(NSUInteger)treeOrder;
+
+/// Returns the tree order of the last model node before treeOrder with an entry in range, or NSNotFound
+/// if there is none.  Pass NSNotFound to find the last in the tree.
+
+- (NSUInteger) treeOrderOfModelNodeInRange:(NSRange)range preceding:(NSUInteger)treeOrder;
+
+/// Returns the model node at the given tree order.
+
+- (id <PSTreeGraphModelNode> ) modelNodeAtTreeOrder:(NSUInteger)treeOrder;
+
+/// Returns YES if the label of modelNode, or a word in it, begins with the given normalized prefix.
+/// Cheap enough to call for each node on screen.
+
+- (BOOL) modelNode:(id <PSTreeGraphModelNode> )modelNode matchesPrefix:(NSString *)prefix;
+
+@end
@@ -0,0 +1,277 @@
+//
+//  PSTreeGraphSearchIndex.m
+//  PSTreeGraphView
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+//
+//  This is a port of the sample code from Max OS X to iOS (iPad).
+//
+//  WWDC 2010 Session 141, “Crafting Custom Cocoa Views”
+//
+
+
+#import "PSTreeGraphSearchIndex.h"
+#import "PSTreeGraphModelNode.h"
+
+
+#pragma mark - Index Entry
+
+// One searchable string.  A label with several words produces several entries for the same node.
+
+@interface PSTreeGraphSearchEntry : NSObject
+
+@property (nonatomic, copy) NSString *key;
+@property (nonatomic, strong) id <PSTreeGraphModelNode> modelNode;
+@property (nonatomic, assign) NSUInteger treeOrder;
+
+@end
+
+@implementation PSTreeGraphSearchEntry
+
+@end
+
+
+#pragma mark - Internal Interface
+
+@interface PSTreeGraphSearchIndex ()
+{
+
+@private
+
+    // Entries sorted by key, and the tree order of each, so a range can be scanned without
+    // touching the entry objects.
+    NSArray *_entries;
+    NSUInteger *_treeOrders;
+
+    // Every model node walked, by tree order, and the keys of each labelled node.
+    NSArray *_modelNodesInTreeOrder;
+    NSMapTable *_keysByModelNode;
+}
+
+@end
+
+
+@implementation PSTreeGraphSearchIndex
+
+
+#pragma mark - Instance Initialization
+
+- (instancetype) init { @throw nil; }
+
+- (instancetype) initWithModelRoot:(id <PSTreeGraphModelNode> )modelRoot
+                     labelProvider:(PSTreeGraphLabelProvider)labelProvider
+{
+    NSParameterAssert(modelRoot != nil);
+    NSParameterAssert(labelProvider != nil);
+
+    self = [super init];
+    if (self) {
+        _modelRoot = modelRoot;
+
+        NSMutableArray *entries = [NSMutableArray array];
+        NSMutableArray *modelNodesInTreeOrder = [NSMutableArray array];
+        _keysByModelNode = [NSMapTable strongToStrongObjectsMapTable];
+        NSUInteger treeOrder = 0;
+
+        // Depth first walk of the model, without recursion, so very deep trees can't overflow the
+        // (smaller) stack of a background thread.  Shared nodes are only visited once, using the same
+        // isEqual: equality as the TreeGraph's model node to SubtreeView map.
+        NSMutableSet *visitedModelNodes = [NSMutableSet set];
+        NSMutableArray *stack = [NSMutableArray arrayWithObject:modelRoot];
+        while (stack.count > 0) {
+            @autoreleasepool {
+                id <PSTreeGraphModelNode> modelNode = stack.lastObject;
+                [stack removeLastObject];
+
+                if ([visitedModelNodes containsObject:modelNode]) {
+                    continue;
+                }
+                [visitedModelNodes addObject:modelNode];
+
+                NSString *label = labelProvider(modelNode);
+                if (label.length > 0) {
+                    [self addEntriesForLabel:label modelNode:modelNode treeOrder:treeOrder toArray:entries];
+                }
+                [modelNodesInTreeOrder addObject:modelNode];
+                ++treeOrder;
+
+                // Push children in reverse, so they are visited in order.
+                NSArray *childModelNodes = [modelNode childModelNodes];
+                for (id <PSTreeGraphModelNode> childModelNode in [childModelNodes reverseObjectEnumerator]) {
+                    [stack addObject:childModelNode];
+                }
+            }
+        }
+
+        [entries sortUsingComparator:^NSComparisonResult(PSTreeGraphSearchEntry *a, PSTreeGraphSearchEntry *b) {
+            return [a.key compare:b.key options:NSLiteralSearch];
+        }];
+        _entries = [entries copy];
+        _modelNodesInTreeOrder = [modelNodesInTreeOrder copy];
+
+        _treeOrders = malloc(MAX(_entries.count, 1) * sizeof(NSUInteger));
+        [_entries enumerateObjectsUsingBlock:^(PSTreeGraphSearchEntry *entry, NSUInteger index, BOOL *stop) {
+            self->_treeOrders[index] = entry.treeOrder;
+        }];
+    }
+    return self;
+}
+
+- (void) dealloc
+{
+    free(_treeOrders);
+}
+
+- (void) addEntriesForLabel:(NSString *)label
+                  modelNode:(id <PSTreeGraphModelNode> )modelNode
+                  treeOrder:(NSUInteger)treeOrder
+                    toArray:(NSMutableArray *)entries
+{
+    NSString *normalizedLabel = [[self class] normalizedString:label];
+
+    // Index the whole label, so a search can run across word breaks, and each later word on its own.
+    NSMutableSet *keys = [NSMutableSet setWithObject:normalizedLabel];
+    [normalizedLabel enumerateSubstringsInRange:NSMakeRange(0, normalizedLabel.length)
+                                        options:(NSStringEnumerationByWords | NSStringEnumerationSubstringNotRequired)
+                                     usingBlock:^(NSString *word, NSRange wordRange, NSRange enclosingRange, BOOL *stop) {
+        [keys addObject:[normalizedLabel substringFromIndex:wordRange.location]];
+    }];
+
+    [_keysByModelNode setObject:[keys allObjects] forKey:modelNode];
+
+    for (NSString *key in keys) {
+        PSTreeGraphSearchEntry *entry = [[PSTreeGraphSearchEntry alloc] init];
+        entry.key = key;
+        entry.modelNode = modelNode;
+        entry.treeOrder = treeOrder;
+        [entries addObject:entry];
+    }
+}
+
+
+#pragma mark - Searching
+
++ (NSString *) normalizedString:(NSString *)string
+{
+    return [string stringByFoldingWithOptions:(NSCaseInsensitiveSearch | NSDiacriticInsensitiveSearch)
+                                       locale:nil];
+}
+
+- (NSRange) fullRange
+{
+    return NSMakeRange(0, _entries.count);
+}
+
+- (NSRange) rangeOfEntriesWithPrefix:(NSString *)prefix inRange:(NSRange)range
+{
+    NSParameterAssert(NSMaxRange(range) <= _entries.count);
+
+    if (prefix.length == 0) {
+        return range;
+    }
+
+    // Entries sharing a prefix are contiguous in literal sort order.  Find the first entry that
+    // sorts at or after the prefix, then the first entry after that one that doesn't begin with it.
+
+    NSUInteger low = range.location;
+    NSUInteger high = NSMaxRange(range);
+    while (low < high) {
+        NSUInteger mid = low + (high - low) / 2;
+        NSString *key = ((PSTreeGraphSearchEntry *)_entries[mid]).key;
+        if ([key compare:prefix options:NSLiteralSearch] == NSOrderedAscending) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    NSUInteger first = low;
+
+    high = NSMaxRange(range);
+    while (low < high) {
+        NSUInteger mid = low + (high - low) / 2;
+        NSString *key = ((PSTreeGraphSearchEntry *)_entries[mid]).key;
+        if ([key hasPrefix:prefix]) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return NSMakeRange(first, low - first);
+}
+
+static int CompareTreeOrders(const void *a, const void *b)
+{
+    NSUInteger ta = *(const NSUInteger *)a;
+    NSUInteger tb = *(const NSUInteger *)b;
+    return (ta < tb) ? -1 : ((ta > tb) ? 1 : 0);
+}
+
+- (NSArray *) modelNodesInRange:(NSRange)range
+{
+    NSParameterAssert(NSMaxRange(range) <= _entries.count);
+
+    NSUInteger *treeOrders = malloc(MAX(range.length, 1) * sizeof(NSUInteger));
+    memcpy(treeOrders, _treeOrders + range.location, range.length * sizeof(NSUInteger));
+    qsort(treeOrders, range.length, sizeof(NSUInteger), CompareTreeOrders);
+
+    // Entries for the same node are now adjacent.
+    NSMutableArray *modelNodes = [NSMutableArray arrayWithCapacity:range.length];
+    for (NSUInteger i = 0; i < range.length; i++) {
+        if (i == 0 || treeOrders[i] != treeOrders[i - 1]) {
+            [modelNodes addObject:_modelNodesInTreeOrder[treeOrders[i]]];
+        }
+    }
+    free(treeOrders);
+
+    return modelNodes;
+}
+
+- (NSUInteger) treeOrderOfModelNodeInRange:(NSRange)range following:(NSUInteger)treeOrder
+{
+    NSParameterAssert(NSMaxRange(range) <= _entries.count);
+
+    // One pass over the tree orders in range.  No sorting, and no allocation.
+    NSUInteger best = NSNotFound;
+    for (NSUInteger i = range.location; i < NSMaxRange(range); i++) {
+        NSUInteger candidate = _treeOrders[i];
+        if ((treeOrder == NSNotFound || candidate > treeOrder) && (best == NSNotFound || candidate < best)) {
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+- (NSUInteger) treeOrderOfModelNodeInRange:(NSRange)range preceding:(NSUInteger)treeOrder
+{
+    NSParameterAssert(NSMaxRange(range) <= _entries.count);
+
+    NSUInteger best = NSNotFound;
+    for (NSUInteger i = range.location; i < NSMaxRange(range); i++) {
+        NSUInteger candidate = _treeOrders[i];
+        if ((treeOrder == NSNotFound || candidate < treeOrder) && (best == NSNotFound || candidate > best)) {
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+- (id <PSTreeGraphModelNode> ) modelNodeAtTreeOrder:(NSUInteger)treeOrder
+{
+    return _modelNodesInTreeOrder[treeOrder];
+}
+
+- (BOOL) modelNode:(id <PSTreeGraphModelNode> )modelNode matchesPrefix:(NSString *)prefix
+{
+    for (NSString *key in [_keysByModelNode objectForKey:modelNode]) {
+        if ([key hasPrefix:prefix]) {
+            return YES;
+        }
+    }
+    return NO;
+}
+
+
+@end
@@ -0,0 +1,21 @@
+//
+//  ConnectorRebuildTests.h
+//  PSTTreeGraphTests
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "PSBaseTreeGraphView.h"
+
+@class TestModelNode;
+
+@interface ConnectorRebuildTests : XCTestCase
+{
+    TestModelNode* model;
+    PSBaseTreeGraphView* aTreeGraph;
+}
+
+@end
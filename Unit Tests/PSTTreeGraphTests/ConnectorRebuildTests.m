@@ -0,0 +1,108 @@
+//
+//  ConnectorRebuildTests.m
+//  PSTTreeGraphTests
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+
+#import "ConnectorRebuildTests.h"
+
+#import "PSBaseTreeGraphView_Internal.h"
+#import "PSBaseSubtreeView.h"
+#import "PSBaseBranchView.h"
+
+#import "TestModelNode.h"
+#import "TestNodeViewNib.h"
+
+
+@implementation ConnectorRebuildTests
+
+- (void)setUp
+{
+    [super setUp];
+
+    // Set-up code here.
+
+    model = [TestModelNode treeWithDepth:4 breadth:3];
+
+    aTreeGraph = [[PSBaseTreeGraphView alloc] initWithFrame:CGRectMake(0.0f, 0.0f, 400.0f, 300.0f)];
+    [TestNodeViewNib installInTreeGraph:aTreeGraph nodeSize:CGSizeMake(100.0f, 30.0f)];
+    aTreeGraph.modelRoot = model;
+}
+
+- (void)tearDown
+{
+    // Tear-down code here.
+
+    [super tearDown];
+}
+
+- (PSBaseSubtreeView *) subtreeViewNamed:(NSString *)name
+{
+    return [aTreeGraph subtreeViewForModelNode:[model nodeNamed:name]];
+}
+
+- (PSBaseBranchView *) branchViewOfSubtreeView:(PSBaseSubtreeView *)subtreeView
+{
+    for (UIView *subview in subtreeView.subviews) {
+        if ([subview isKindOfClass:[PSBaseBranchView class]]) {
+            return (PSBaseBranchView *)subview;
+        }
+    }
+    return nil;
+}
+
+// The SubtreeViews from subtreeView up to the root that draw connecting lines.
+
+- (NSArray *) connectedSubtreeViewsFrom:(PSBaseSubtreeView *)subtreeView
+{
+    NSMutableArray *subtreeViews = [NSMutableArray array];
+    for (UIView *view = subtreeView; [view isKindOfClass:[PSBaseSubtreeView class]]; view = view.superview) {
+        PSBaseBranchView *branchView = [self branchViewOfSubtreeView:(PSBaseSubtreeView *)view];
+        if ( branchView && !branchView.hidden ) {
+            [subtreeViews addObject:view];
+        }
+    }
+    return subtreeViews;
+}
+
+
+#pragma mark - Incremental Layout
+
+- (void)testLeafLayoutRebuildsOnlyAncestorConnectors
+{
+    PSBaseSubtreeView *leafSubtreeView = [self subtreeViewNamed:@"root.0.0.0"];
+    NSArray *ancestorSubtreeViews = [self connectedSubtreeViewsFrom:leafSubtreeView];
+    XCTAssertEqual(ancestorSubtreeViews.count, (NSUInteger)3, @"Expected root.0.0, root.0 and root to draw lines.");
+
+    [leafSubtreeView setNeedsGraphLayoutIncludingAncestors];
+    [aTreeGraph layoutGraphIfNeeded];
+
+    XCTAssertEqual(aTreeGraph.connectorPathRebuildCount, ancestorSubtreeViews.count);
+    for (PSBaseSubtreeView *subtreeView in ancestorSubtreeViews) {
+        XCTAssertFalse([self branchViewOfSubtreeView:subtreeView].needsConnectionsUpdate);
+    }
+}
+
+- (void)testBranchLayoutRebuildsItselfAndAncestors
+{
+    PSBaseSubtreeView *branchSubtreeView = [self subtreeViewNamed:@"root.2.1"];
+
+    [branchSubtreeView setNeedsGraphLayoutIncludingAncestors];
+    [aTreeGraph layoutGraphIfNeeded];
+
+    // root.2.1, root.2 and root.  Its children, and every other branch, keep their lines.
+    XCTAssertEqual(aTreeGraph.connectorPathRebuildCount, [self connectedSubtreeViewsFrom:branchSubtreeView].count);
+}
+
+- (void)testFullLayoutRebuildsEveryConnector
+{
+    [aTreeGraph.rootSubtreeView recursiveSetNeedsGraphLayout];
+    [aTreeGraph layoutGraphIfNeeded];
+
+    // Every node above the leaves: 1 + 3 + 9.
+    XCTAssertEqual(aTreeGraph.connectorPathRebuildCount, (NSUInteger)13);
+}
+
+@end
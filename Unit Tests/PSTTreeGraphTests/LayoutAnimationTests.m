@@ -0,0 +1,119 @@
+//
+//  LayoutAnimationTests.m
+//  PSTTreeGraphTests
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+
+#import "LayoutAnimationTests.h"
+
+#import <QuartzCore/QuartzCore.h>
+
+#import "PSBaseTreeGraphView_Internal.h"
+#import "PSBaseSubtreeView.h"
+
+#import "TestModelNode.h"
+#import "TestNodeViewNib.h"
+
+
+@implementation LayoutAnimationTests
+
+- (void)setUp
+{
+    [super setUp];
+
+    // Set-up code here.
+
+    model = [TestModelNode treeWithDepth:3 breadth:3];
+
+    aTreeGraph = [[PSBaseTreeGraphView alloc] initWithFrame:CGRectMake(0.0f, 0.0f, 1024.0f, 768.0f)];
+    [TestNodeViewNib installInTreeGraph:aTreeGraph nodeSize:CGSizeMake(100.0f, 30.0f)];
+    aTreeGraph.modelRoot = model;
+    XCTAssertFalse([aTreeGraph needsGraphLayout], @"Assigning a modelRoot should lay out the tree.");
+}
+
+- (void)tearDown
+{
+    // Tear-down code here.
+
+    [super tearDown];
+}
+
+- (NSUInteger) countOfPositionAnimationsInView:(UIView *)view
+{
+    NSUInteger count = ([view.layer animationForKey:@"PSTreeGraphLayoutPosition"] != nil) ? 1 : 0;
+    for (UIView *subview in view.subviews) {
+        count += [self countOfPositionAnimationsInView:subview];
+    }
+    return count;
+}
+
+- (CGRect) collapseNodeNamed:(NSString *)name animated:(BOOL)animated
+{
+    // Collapsing the first child moves its later siblings.
+    PSBaseSubtreeView *movedSubtreeView = [aTreeGraph subtreeViewForModelNode:[model nodeNamed:@"root.2"]];
+    CGRect previousFrame = movedSubtreeView.frame;
+
+    [aTreeGraph subtreeViewForModelNode:[model nodeNamed:name]].expanded = NO;
+    XCTAssertTrue([aTreeGraph needsGraphLayout]);
+
+    [aTreeGraph layoutGraphIfNeededAnimated:animated];
+
+    XCTAssertFalse([aTreeGraph needsGraphLayout]);
+    XCTAssertFalse(CGRectEqualToRect(previousFrame, movedSubtreeView.frame), @"Collapsing should have moved root.2.");
+    return movedSubtreeView.frame;
+}
+
+
+#pragma mark - Animation
+
+- (void)testAnimatedLayoutAnimatesMovedViews
+{
+    [self collapseNodeNamed:@"root.0" animated:YES];
+
+    PSBaseSubtreeView *movedSubtreeView = [aTreeGraph subtreeViewForModelNode:[model nodeNamed:@"root.2"]];
+    XCTAssertNotNil([movedSubtreeView.layer animationForKey:@"PSTreeGraphLayoutPosition"], @"A moved view wasn't animated.");
+}
+
+- (void)testSuppressedLayoutAnimationJumpsToFinalLayout
+{
+    aTreeGraph.layoutAnimationSuppressed = YES;
+    [self collapseNodeNamed:@"root.0" animated:YES];
+
+    XCTAssertEqual([self countOfPositionAnimationsInView:aTreeGraph], (NSUInteger)0,
+                   @"Layout was animated while animation was suppressed.");
+}
+
+- (void)testDisabledLayoutAnimationJumpsToFinalLayout
+{
+    aTreeGraph.animatesLayout = NO;
+    [self collapseNodeNamed:@"root.0" animated:YES];
+
+    XCTAssertEqual([self countOfPositionAnimationsInView:aTreeGraph], (NSUInteger)0,
+                   @"Layout was animated with animatesLayout off.");
+}
+
+- (void)testUnanimatedLayoutAddsNoAnimations
+{
+    [self collapseNodeNamed:@"root.0" animated:NO];
+
+    XCTAssertEqual([self countOfPositionAnimationsInView:aTreeGraph], (NSUInteger)0);
+}
+
+- (void)testSuppressedAndAnimatedLayoutsAgree
+{
+    aTreeGraph.layoutAnimationSuppressed = YES;
+    CGRect suppressedFrame = [self collapseNodeNamed:@"root.0" animated:YES];
+
+    PSBaseTreeGraphView *animatedTreeGraph = [[PSBaseTreeGraphView alloc] initWithFrame:aTreeGraph.frame];
+    [TestNodeViewNib installInTreeGraph:animatedTreeGraph nodeSize:CGSizeMake(100.0f, 30.0f)];
+    animatedTreeGraph.modelRoot = model;
+    [animatedTreeGraph subtreeViewForModelNode:[model nodeNamed:@"root.0"]].expanded = NO;
+    [animatedTreeGraph layoutGraphIfNeededAnimated:YES];
+
+    // Animation only changes how the layout gets there, not where it ends up.
+    XCTAssertTrue(CGRectEqualToRect(suppressedFrame, [animatedTreeGraph subtreeViewForModelNode:[model nodeNamed:@"root.2"]].frame));
+}
+
+@end
@@ -0,0 +1,19 @@
+//
+//  LayoutCacheTests.h
+//  PSTTreeGraphTests
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+@class TestModelNode;
+
+@interface LayoutCacheTests : XCTestCase
+{
+    TestModelNode* model;
+    NSURL* cacheURL;
+}
+
+@end
@@ -0,0 +1,155 @@
+//
+//  LayoutCacheTests.m
+//  PSTTreeGraphTests
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+
+#import "LayoutCacheTests.h"
+
+#import "PSBaseTreeGraphView.h"
+#import "PSBaseTreeGraphView_Internal.h"
+#import "PSBaseSubtreeView.h"
+#import "PSTreeGraphLayoutCache.h"
+
+#import "TestModelNode.h"
+#import "TestNodeViewNib.h"
+
+
+@implementation LayoutCacheTests
+
+- (void)setUp
+{
+    [super setUp];
+
+    // Set-up code here.
+
+    model = [TestModelNode treeWithDepth:3 breadth:3];
+
+    NSString *fileName = [NSString stringWithFormat:@"LayoutCacheTests-%@.layout", [NSUUID UUID].UUIDString];
+    cacheURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:fileName]];
+}
+
+- (void)tearDown
+{
+    // Tear-down code here.
+
+    [[NSFileManager defaultManager] removeItemAtURL:cacheURL error:NULL];
+
+    [super tearDown];
+}
+
+- (PSBaseTreeGraphView *) treeGraphWithNodeSize:(CGSize)nodeSize
+{
+    PSBaseTreeGraphView *treeGraph = [[PSBaseTreeGraphView alloc] initWithFrame:CGRectMake(0.0f, 0.0f, 1024.0f, 768.0f)];
+    [TestNodeViewNib installInTreeGraph:treeGraph nodeSize:nodeSize];
+    treeGraph.layoutCacheURL = cacheURL;
+    return treeGraph;
+}
+
+- (PSBaseTreeGraphView *) writeCacheWithCollapsedNodeNamed:(NSString *)name
+{
+    PSBaseTreeGraphView *treeGraph = [self treeGraphWithNodeSize:CGSizeMake(100.0f, 30.0f)];
+    treeGraph.modelRoot = model;
+
+    [treeGraph subtreeViewForModelNode:[model nodeNamed:name]].expanded = NO;
+
+    NSError *error = nil;
+    XCTAssertTrue([treeGraph writeLayoutCache:&error], @"Couldn't write layout cache: %@", error);
+    return treeGraph;
+}
+
+
+#pragma mark - Round Trip
+
+- (void)testRoundTripRestoresLayoutAndExpansion
+{
+    PSBaseTreeGraphView *writtenTreeGraph = [self writeCacheWithCollapsedNodeNamed:@"root.1"];
+
+    PSTreeGraphLayoutCache *layoutCache = [[PSTreeGraphLayoutCache alloc] initWithContentsOfURL:cacheURL];
+    XCTAssertNotNil(layoutCache, @"Couldn't map layout cache.");
+    XCTAssertEqual(layoutCache.recordCount, (NSUInteger)13, @"Expected one record per SubtreeView.");
+
+    // Assigning the modelRoot restores the cached layout.  A fresh build would have root.1 expanded.
+    PSBaseTreeGraphView *treeGraph = [self treeGraphWithNodeSize:CGSizeMake(100.0f, 30.0f)];
+    treeGraph.modelRoot = model;
+
+    XCTAssertFalse([treeGraph subtreeViewForModelNode:[model nodeNamed:@"root.1"]].expanded,
+                   @"Expansion state wasn't restored.");
+    XCTAssertTrue([treeGraph subtreeViewForModelNode:[model nodeNamed:@"root.2"]].expanded,
+                  @"Expansion state wasn't restored.");
+
+    for (NSString *name in @[ @"root", @"root.0", @"root.0.2", @"root.1", @"root.2.1" ]) {
+        TestModelNode *node = [model nodeNamed:name];
+        XCTAssertTrue(CGRectEqualToRect([treeGraph subtreeViewForModelNode:node].frame,
+                                        [writtenTreeGraph subtreeViewForModelNode:node].frame),
+                      @"Frame of %@ wasn't restored.", name);
+    }
+    XCTAssertTrue(CGRectEqualToRect(treeGraph.frame, writtenTreeGraph.frame), @"TreeGraph wasn't sized to the cached layout.");
+}
+
+
+#pragma mark - Invalidation
+
+- (void)testLayoutMetricsChangeIsRejected
+{
+    [self writeCacheWithCollapsedNodeNamed:@"root.1"];
+
+    PSBaseTreeGraphView *treeGraph = [self treeGraphWithNodeSize:CGSizeMake(100.0f, 30.0f)];
+    treeGraph.siblingSpacing = treeGraph.siblingSpacing + 10.0f;
+    treeGraph.modelRoot = model;
+
+    PSTreeGraphLayoutCache *layoutCache = [[PSTreeGraphLayoutCache alloc] initWithContentsOfURL:cacheURL];
+    XCTAssertNotEqual(layoutCache.fingerprint, [PSTreeGraphLayoutCache fingerprintForTreeGraph:treeGraph]);
+    XCTAssertFalse([layoutCache applyToTreeGraph:treeGraph], @"Applied a layout made with other metrics.");
+    XCTAssertTrue([treeGraph subtreeViewForModelNode:[model nodeNamed:@"root.1"]].expanded,
+                  @"A rejected layout changed the tree.");
+}
+
+- (void)testChangedModelIsRejected
+{
+    [self writeCacheWithCollapsedNodeNamed:@"root.1"];
+
+    [model nodeNamed:@"root.2.1"].identifier = @"replaced";
+
+    PSBaseTreeGraphView *treeGraph = [self treeGraphWithNodeSize:CGSizeMake(100.0f, 30.0f)];
+    treeGraph.modelRoot = model;
+
+    PSTreeGraphLayoutCache *layoutCache = [[PSTreeGraphLayoutCache alloc] initWithContentsOfURL:cacheURL];
+    XCTAssertEqual(layoutCache.fingerprint, [PSTreeGraphLayoutCache fingerprintForTreeGraph:treeGraph]);
+    XCTAssertFalse([layoutCache applyToTreeGraph:treeGraph], @"Applied a layout made for another model.");
+    XCTAssertTrue([treeGraph subtreeViewForModelNode:[model nodeNamed:@"root.1"]].expanded,
+                  @"A rejected layout changed the tree.");
+}
+
+- (void)testChangedNodeSizeIsRejected
+{
+    [self writeCacheWithCollapsedNodeNamed:@"root.1"];
+
+    PSBaseTreeGraphView *treeGraph = [self treeGraphWithNodeSize:CGSizeMake(120.0f, 30.0f)];
+    treeGraph.modelRoot = model;
+
+    PSTreeGraphLayoutCache *layoutCache = [[PSTreeGraphLayoutCache alloc] initWithContentsOfURL:cacheURL];
+    XCTAssertFalse([layoutCache applyToTreeGraph:treeGraph], @"Applied a layout made for other node sizes.");
+
+    UIView *nodeView = [treeGraph subtreeViewForModelNode:model].nodeView;
+    XCTAssertEqual(nodeView.bounds.size.width, (CGFloat)120.0f, @"A rejected layout resized a nodeView.");
+}
+
+- (void)testModelWithoutIdentifiersIsNotCached
+{
+    [model nodeNamed:@"root.0.1"].identifier = nil;
+
+    PSBaseTreeGraphView *treeGraph = [self treeGraphWithNodeSize:CGSizeMake(100.0f, 30.0f)];
+    treeGraph.modelRoot = model;
+
+    XCTAssertFalse([PSTreeGraphLayoutCache canCacheLayoutOfTreeGraph:treeGraph]);
+
+    NSError *error = nil;
+    XCTAssertFalse([treeGraph writeLayoutCache:&error], @"Wrote a layout that can't be matched to its model.");
+    XCTAssertEqual(error.code, (NSInteger)NSFeatureUnsupportedError);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:cacheURL.path]);
+}
+
+@end
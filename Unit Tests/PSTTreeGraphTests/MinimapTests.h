@@ -0,0 +1,26 @@
+//
+//  MinimapTests.h
+//  PSTTreeGraphTests
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "PSBaseTreeGraphView.h"
+
+@class TestModelNode;
+@class RecordingMinimapView;
+
+@interface MinimapTests : XCTestCase
+{
+    TestModelNode* model;
+    UIScrollView* aScrollView;
+    PSBaseTreeGraphView* aTreeGraph;
+    RecordingMinimapView* aMinimap;
+    NSDictionary* lastLayoutUserInfo;
+    id layoutObserver;
+}
+
+@end
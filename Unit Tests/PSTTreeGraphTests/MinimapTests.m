@@ -0,0 +1,188 @@
+//
+//  MinimapTests.m
+//  PSTTreeGraphTests
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+
+#import "MinimapTests.h"
+
+#import "PSBaseTreeGraphView_Internal.h"
+#import "PSBaseSubtreeView.h"
+#import "PSTreeGraphMinimapView.h"
+
+#import "TestModelNode.h"
+#import "TestNodeViewNib.h"
+
+
+#pragma mark - Recording Minimap
+
+@interface PSTreeGraphMinimapView (Testing)
+
+- (void) updateTreeImageInGraphRect:(CGRect)dirtyRect;
+
+@end
+
+// Records the part of the TreeGraph each bitmap update redraws.  CGRectNull means all of it.
+
+@interface RecordingMinimapView : PSTreeGraphMinimapView
+
+@property (nonatomic, readonly) NSMutableArray *redrawnGraphRects;
+
+@end
+
+@implementation RecordingMinimapView
+
+- (NSMutableArray *) redrawnGraphRects
+{
+    if (_redrawnGraphRects == nil) {
+        _redrawnGraphRects = [[NSMutableArray alloc] init];
+    }
+    return _redrawnGraphRects;
+}
+
+- (void) updateTreeImageInGraphRect:(CGRect)dirtyRect
+{
+    [self.redrawnGraphRects addObject:[NSValue valueWithCGRect:dirtyRect]];
+    [super updateTreeImageInGraphRect:dirtyRect];
+}
+
+@end
+
+
+@implementation MinimapTests
+
+- (void)setUp
+{
+    [super setUp];
+
+    // Set-up code here.
+
+    model = [TestModelNode treeWithDepth:3 breadth:3];
+
+    aScrollView = [[UIScrollView alloc] initWithFrame:CGRectMake(0.0f, 0.0f, 400.0f, 300.0f)];
+    aTreeGraph = [[PSBaseTreeGraphView alloc] initWithFrame:aScrollView.bounds];
+    [aScrollView addSubview:aTreeGraph];
+
+    [TestNodeViewNib installInTreeGraph:aTreeGraph nodeSize:CGSizeMake(100.0f, 30.0f)];
+    aTreeGraph.modelRoot = model;
+    aScrollView.contentSize = aTreeGraph.frame.size;
+
+    aMinimap = [[RecordingMinimapView alloc] initWithFrame:CGRectMake(0.0f, 0.0f, 200.0f, 150.0f)];
+    aMinimap.treeGraph = aTreeGraph;
+    [aMinimap layoutIfNeeded];
+    [aMinimap.redrawnGraphRects removeAllObjects];
+
+    __weak MinimapTests *weakSelf = self;
+    layoutObserver = [[NSNotificationCenter defaultCenter] addObserverForName:PSTreeGraphViewDidLayoutNotification
+                                                                       object:aTreeGraph
+                                                                        queue:nil
+                                                                   usingBlock:^(NSNotification *notification) {
+        MinimapTests *strongSelf = weakSelf;
+        if (strongSelf) {
+            strongSelf->lastLayoutUserInfo = notification.userInfo;
+        }
+    }];
+}
+
+- (void)tearDown
+{
+    // Tear-down code here.
+
+    [[NSNotificationCenter defaultCenter] removeObserver:layoutObserver];
+
+    [super tearDown];
+}
+
+- (CGRect) rectOfModelNode:(TestModelNode *)modelNode
+{
+    UIView *nodeView = [aTreeGraph subtreeViewForModelNode:modelNode].nodeView;
+    return [aTreeGraph convertRect:nodeView.bounds fromView:nodeView];
+}
+
+// Narrows one leaf's node, which changes its subtree's frame without changing the TreeGraph's size.
+// Returns the leaf's frame, in TreeGraph coordinates, from before the change.
+
+- (CGRect) narrowLeafNamed:(NSString *)name
+{
+    PSBaseSubtreeView *leafSubtreeView = [aTreeGraph subtreeViewForModelNode:[model nodeNamed:name]];
+    CGRect previousRect = [aTreeGraph convertRect:leafSubtreeView.bounds fromView:leafSubtreeView];
+    CGSize previousSize = aTreeGraph.bounds.size;
+
+    CGRect nodeFrame = leafSubtreeView.nodeView.frame;
+    nodeFrame.size.width = 50.0f;
+    leafSubtreeView.nodeView.frame = nodeFrame;
+
+    [leafSubtreeView setNeedsGraphLayoutIncludingAncestors];
+    [aTreeGraph layoutGraphIfNeeded];
+    XCTAssertTrue(CGSizeEqualToSize(aTreeGraph.bounds.size, previousSize), @"Expected the TreeGraph to keep its size.");
+
+    return previousRect;
+}
+
+
+#pragma mark - Changed Rect
+
+- (void)testChangedRectCoversOnlyMovedSubtrees
+{
+    TestModelNode *leaf = [model nodeNamed:@"root.1.1"];
+    CGRect previousRect = [self narrowLeafNamed:leaf.name];
+
+    NSValue *changedRectValue = lastLayoutUserInfo[PSTreeGraphViewChangedRectKey];
+    XCTAssertNotNil(changedRectValue, @"Expected the changed rect to be reported while a minimap is attached.");
+    CGRect changedRect = changedRectValue.CGRectValue;
+
+    XCTAssertTrue(CGRectContainsRect(changedRect, previousRect));
+    XCTAssertTrue(CGRectContainsRect(changedRect, [self rectOfModelNode:leaf]));
+
+    for (TestModelNode *parent in @[ model, [model nodeNamed:@"root.0"], [model nodeNamed:@"root.1"], [model nodeNamed:@"root.2"] ]) {
+        for (TestModelNode *modelNode in [@[ parent ] arrayByAddingObjectsFromArray:parent.children]) {
+            if (modelNode != leaf) {
+                XCTAssertFalse(CGRectIntersectsRect(changedRect, [self rectOfModelNode:modelNode]),
+                               @"The changed rect covers %@, which did not move.", modelNode.name);
+            }
+        }
+    }
+}
+
+- (void)testChangedRectNotReportedWithoutMinimap
+{
+    aMinimap.treeGraph = nil;
+    [self narrowLeafNamed:@"root.1.1"];
+
+    XCTAssertNil(lastLayoutUserInfo[PSTreeGraphViewChangedRectKey]);
+}
+
+
+#pragma mark - Partial Redraw
+
+- (void)testMinimapRedrawsOnlyChangedRect
+{
+    [self narrowLeafNamed:@"root.1.1"];
+    CGRect changedRect = [lastLayoutUserInfo[PSTreeGraphViewChangedRectKey] CGRectValue];
+
+    [aMinimap layoutIfNeeded];
+
+    XCTAssertEqual(aMinimap.redrawnGraphRects.count, (NSUInteger)1);
+    CGRect redrawnRect = [aMinimap.redrawnGraphRects.firstObject CGRectValue];
+    XCTAssertFalse(CGRectIsNull(redrawnRect), @"The whole minimap was redrawn.");
+    XCTAssertTrue(CGRectEqualToRect(redrawnRect, changedRect));
+}
+
+- (void)testMinimapRedrawsEverythingWhenTreeGraphResizes
+{
+    PSBaseSubtreeView *leafSubtreeView = [aTreeGraph subtreeViewForModelNode:[model nodeNamed:@"root.1.1"]];
+    CGRect nodeFrame = leafSubtreeView.nodeView.frame;
+    nodeFrame.size.height = 300.0f;
+    leafSubtreeView.nodeView.frame = nodeFrame;
+
+    [leafSubtreeView setNeedsGraphLayoutIncludingAncestors];
+    [aTreeGraph layoutGraphIfNeeded];
+    [aMinimap layoutIfNeeded];
+
+    XCTAssertEqual(aMinimap.redrawnGraphRects.count, (NSUInteger)1);
+    XCTAssertTrue(CGRectIsNull([aMinimap.redrawnGraphRects.firstObject CGRectValue]));
+}
+
+@end
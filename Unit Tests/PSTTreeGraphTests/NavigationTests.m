@@ -0,0 +1,217 @@
+//
+//  NavigationTests.m
+//  PSTTreeGraphTests
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+
+#import "NavigationTests.h"
+
+#import "PSBaseTreeGraphView_Internal.h"
+#import "PSBaseSubtreeView.h"
+
+#import "TestModelNode.h"
+#import "TestNodeViewNib.h"
+
+
+@implementation NavigationTests
+
+- (void)setUp
+{
+    [super setUp];
+
+    // Set-up code here.
+
+    // Laid out horizontally in three columns: root, its children, and nine leaves.  Each parent is
+    // centered across from its middle child.
+    model = [TestModelNode treeWithDepth:3 breadth:3];
+
+    aScrollView = [[UIScrollView alloc] initWithFrame:CGRectMake(0.0f, 0.0f, 400.0f, 2000.0f)];
+    aTreeGraph = [[PSBaseTreeGraphView alloc] initWithFrame:aScrollView.bounds];
+    aTreeGraph.resizesToFillEnclosingScrollView = NO;
+    [aScrollView addSubview:aTreeGraph];
+
+    [TestNodeViewNib installInTreeGraph:aTreeGraph nodeSize:CGSizeMake(100.0f, 30.0f)];
+    aTreeGraph.modelRoot = model;
+}
+
+- (void)tearDown
+{
+    // Tear-down code here.
+
+    [super tearDown];
+}
+
+- (void) selectNodeNamed:(NSString *)name
+{
+    aTreeGraph.selectedModelNodes = [NSSet setWithObject:[model nodeNamed:name]];
+}
+
+- (NSString *) nameOfSelectedNode
+{
+    return ((TestModelNode *)aTreeGraph.singleSelectedModelNode).name;
+}
+
+- (void) waitForNavigation
+{
+    // Moves are applied on the next frame.  Rather than wait for the display link, apply them now.
+    [aTreeGraph applyPendingNavigationIfNeeded];
+}
+
+- (CGPoint) centerOfNodeNamed:(NSString *)name
+{
+    UIView *nodeView = [aTreeGraph subtreeViewForModelNode:[model nodeNamed:name]].nodeView;
+    CGRect nodeRect = [aTreeGraph convertRect:nodeView.bounds fromView:nodeView];
+    return CGPointMake(CGRectGetMidX(nodeRect), CGRectGetMidY(nodeRect));
+}
+
+- (NSArray *) leafNamesFromTopToBottom
+{
+    NSMutableArray *names = [NSMutableArray array];
+    for (TestModelNode *child in model.children) {
+        [names addObjectsFromArray:[child.children valueForKey:@"name"]];
+    }
+    [names sortUsingComparator:^NSComparisonResult(NSString *a, NSString *b) {
+        return [@([self centerOfNodeNamed:a].y) compare:@([self centerOfNodeNamed:b].y)];
+    }];
+    return names;
+}
+
+
+#pragma mark - Spatial Navigation
+
+- (void)testMoveRightSelectsNodeStraightAhead
+{
+    XCTAssertEqualWithAccuracy([self centerOfNodeNamed:@"root"].y, [self centerOfNodeNamed:@"root.1"].y, 0.5);
+
+    [self selectNodeNamed:@"root"];
+    [aTreeGraph moveRight:nil];
+    [self waitForNavigation];
+
+    XCTAssertEqualObjects([self nameOfSelectedNode], @"root.1");
+}
+
+- (void)testMoveLeftSelectsNodeStraightBehind
+{
+    [self selectNodeNamed:@"root.2.1"];
+    [aTreeGraph moveLeft:nil];
+    [self waitForNavigation];
+
+    XCTAssertEqualObjects([self nameOfSelectedNode], @"root.2");
+
+    [aTreeGraph moveLeft:nil];
+    [self waitForNavigation];
+
+    XCTAssertEqualObjects([self nameOfSelectedNode], @"root");
+}
+
+- (void)testMoveUpAndDownSelectNeighboursInColumn
+{
+    // Nodes in the same column beat closer ones off to the side.
+    NSArray *leaves = [self leafNamesFromTopToBottom];
+    NSUInteger index = [leaves indexOfObject:@"root.1.1"];
+
+    [self selectNodeNamed:@"root.1.1"];
+    [aTreeGraph moveDown:nil];
+    [self waitForNavigation];
+    XCTAssertEqualObjects([self nameOfSelectedNode], leaves[index + 1]);
+
+    [self selectNodeNamed:@"root.1.1"];
+    [aTreeGraph moveUp:nil];
+    [self waitForNavigation];
+    XCTAssertEqualObjects([self nameOfSelectedNode], leaves[index - 1]);
+}
+
+- (void)testMoveWithNothingAheadKeepsSelection
+{
+    [self selectNodeNamed:@"root.0.0"];
+    [aTreeGraph moveRight:nil];
+    [self waitForNavigation];
+
+    XCTAssertEqualObjects([self nameOfSelectedNode], @"root.0.0");
+}
+
+- (void)testRepeatedMovesAreCoalesced
+{
+    // Several moves before the next frame carry on from one another, and select once.
+    NSArray *leaves = [self leafNamesFromTopToBottom];
+    NSUInteger index = [leaves indexOfObject:@"root.1.1"];
+
+    [self selectNodeNamed:@"root.1.1"];
+    [aTreeGraph moveDown:nil];
+    [aTreeGraph moveDown:nil];
+    XCTAssertEqualObjects([self nameOfSelectedNode], @"root.1.1", @"Selection should change on the next frame.");
+
+    [self waitForNavigation];
+    XCTAssertEqualObjects([self nameOfSelectedNode], leaves[index + 2]);
+}
+
+
+- (void)testMoveToSiblingStepsTowardsLaterSiblings
+{
+    // Later siblings are laid out above earlier ones in a horizontal tree.
+    NSArray *leaves = [self leafNamesFromTopToBottom];
+    XCTAssertEqual([leaves indexOfObject:@"root.1.2"] + 1, [leaves indexOfObject:@"root.1.1"]);
+
+    [self selectNodeNamed:@"root.1.1"];
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+    [aTreeGraph moveToSiblingByRelativeIndex:1];
+#pragma clang diagnostic pop
+    [self waitForNavigation];
+
+    XCTAssertEqualObjects([self nameOfSelectedNode], @"root.1.2");
+}
+
+
+#pragma mark - Home and End
+
+- (void)testMoveToBeginningSelectsRoot
+{
+    [self selectNodeNamed:@"root.2.2"];
+    [aTreeGraph moveToBeginningOfDocument:nil];
+    [self waitForNavigation];
+
+    XCTAssertEqualObjects([self nameOfSelectedNode], @"root");
+}
+
+- (void)testMoveToEndSelectsLastVisibleNode
+{
+    [aTreeGraph moveToEndOfDocument:nil];
+    [self waitForNavigation];
+    XCTAssertEqualObjects([self nameOfSelectedNode], @"root.2.2");
+
+    // Collapsed nodes' descendants aren't visible.
+    [aTreeGraph subtreeViewForModelNode:[model nodeNamed:@"root.2"]].expanded = NO;
+    [aTreeGraph layoutGraphIfNeeded];
+
+    [aTreeGraph moveToEndOfDocument:nil];
+    [self waitForNavigation];
+    XCTAssertEqualObjects([self nameOfSelectedNode], @"root.2");
+}
+
+
+#pragma mark - Index Invalidation
+
+- (void)testResizingToFillScrollViewUpdatesIndex
+{
+    // Build the index where the tree is now.
+    [self selectNodeNamed:@"root"];
+    [aTreeGraph moveRight:nil];
+    [self waitForNavigation];
+    XCTAssertEqualObjects([self nameOfSelectedNode], @"root.1");
+
+    // Filling the (tall) scroll view centers the tree, well below everywhere it was before.
+    CGFloat previousY = [self centerOfNodeNamed:@"root"].y;
+    aTreeGraph.resizesToFillEnclosingScrollView = YES;
+    XCTAssertTrue([self centerOfNodeNamed:@"root"].y > previousY + 400.0f);
+
+    // With positions from before the move, nothing would be below root.
+    [self selectNodeNamed:@"root"];
+    [aTreeGraph moveDown:nil];
+    [self waitForNavigation];
+    XCTAssertFalse([[self nameOfSelectedNode] isEqualToString:@"root"], @"Navigated with a stale index.");
+}
+
+@end
@@ -0,0 +1,24 @@
+//
+//  PrefetchTests.h
+//  PSTTreeGraphTests
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "PSBaseTreeGraphView.h"
+
+@class TestModelNode;
+@class PrefetchingDelegate;
+
+@interface PrefetchTests : XCTestCase
+{
+    TestModelNode* model;
+    PrefetchingDelegate* aDelegate;
+    UIScrollView* aScrollView;
+    PSBaseTreeGraphView* aTreeGraph;
+}
+
+@end
@@ -0,0 +1,161 @@
+//
+//  PrefetchTests.m
+//  PSTTreeGraphTests
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+
+#import "PrefetchTests.h"
+
+#import "PSBaseTreeGraphView_Internal.h"
+#import "PSBaseSubtreeView.h"
+#import "PSTreeGraphDelegate.h"
+
+#import "TestModelNode.h"
+#import "TestNodeViewNib.h"
+
+
+#pragma mark - Prefetching Delegate
+
+// Records what the TreeGraph asks it to prefetch and cancel.
+
+@interface PrefetchingDelegate : NSObject <PSTreeGraphDelegate>
+
+@property (nonatomic, readonly) NSMutableSet *prefetchedModelNodes;
+@property (nonatomic, readonly) NSMutableSet *cancelledModelNodes;
+
+- (void) reset;
+
+@end
+
+@implementation PrefetchingDelegate
+
+- (instancetype) init
+{
+    self = [super init];
+    if (self) {
+        _prefetchedModelNodes = [[NSMutableSet alloc] init];
+        _cancelledModelNodes = [[NSMutableSet alloc] init];
+    }
+    return self;
+}
+
+- (void) reset
+{
+    [_prefetchedModelNodes removeAllObjects];
+    [_cancelledModelNodes removeAllObjects];
+}
+
+- (void) configureNodeView:(UIView *)nodeView withModelNode:(id <PSTreeGraphModelNode> )modelNode
+{
+}
+
+- (void) treeGraph:(PSBaseTreeGraphView *)treeGraph prefetchContentForModelNodes:(NSArray *)modelNodes
+{
+    [_prefetchedModelNodes addObjectsFromArray:modelNodes];
+}
+
+- (void) treeGraph:(PSBaseTreeGraphView *)treeGraph cancelPrefetchingContentForModelNodes:(NSArray *)modelNodes
+{
+    [_cancelledModelNodes addObjectsFromArray:modelNodes];
+}
+
+@end
+
+
+@implementation PrefetchTests
+
+- (void)setUp
+{
+    [super setUp];
+
+    // Set-up code here.
+
+    // Much larger than the scroll view, so most nodes start out of sight.
+    model = [TestModelNode treeWithDepth:4 breadth:3];
+    aDelegate = [[PrefetchingDelegate alloc] init];
+
+    aScrollView = [[UIScrollView alloc] initWithFrame:CGRectMake(0.0f, 0.0f, 400.0f, 300.0f)];
+    aTreeGraph = [[PSBaseTreeGraphView alloc] initWithFrame:aScrollView.bounds];
+    [aScrollView addSubview:aTreeGraph];
+
+    [TestNodeViewNib installInTreeGraph:aTreeGraph nodeSize:CGSizeMake(100.0f, 30.0f)];
+    aTreeGraph.delegate = aDelegate;
+    aTreeGraph.modelRoot = model;
+    aScrollView.contentSize = aTreeGraph.frame.size;
+}
+
+- (void)tearDown
+{
+    // Tear-down code here.
+
+    [super tearDown];
+}
+
+- (CGRect) visibleRect
+{
+    return [aTreeGraph convertRect:aScrollView.bounds fromView:aScrollView];
+}
+
+- (CGRect) rectOfModelNode:(TestModelNode *)modelNode
+{
+    UIView *nodeView = [aTreeGraph subtreeViewForModelNode:modelNode].nodeView;
+    return [aTreeGraph convertRect:nodeView.bounds fromView:nodeView];
+}
+
+- (void) scrollBy:(CGFloat)dy
+{
+    CGPoint contentOffset = aScrollView.contentOffset;
+    aScrollView.contentOffset = CGPointMake(contentOffset.x, contentOffset.y + dy);
+    [aTreeGraph parentClipViewDidScroll:aScrollView];
+}
+
+
+#pragma mark - Prefetching
+
+- (void)testPrefetchesNodesAroundInitialView
+{
+    XCTAssertTrue(aDelegate.prefetchedModelNodes.count > 0, @"Expected the nodes in view to be prefetched.");
+    XCTAssertEqual(aDelegate.cancelledModelNodes.count, (NSUInteger)0);
+}
+
+- (void)testPrefetchesNodesAheadOfScroll
+{
+    [self scrollBy:100.0f];
+    [aDelegate reset];
+
+    // Scrolling down looks one screen further down, and nowhere else.
+    [self scrollBy:100.0f];
+    CGRect visibleRect = [self visibleRect];
+    CGRect aheadRect = CGRectOffset(visibleRect, 0.0f, visibleRect.size.height);
+
+    XCTAssertTrue(aDelegate.prefetchedModelNodes.count > 0, @"Expected nodes ahead of the scroll to be prefetched.");
+    for (TestModelNode *modelNode in aDelegate.prefetchedModelNodes) {
+        CGRect rect = [self rectOfModelNode:modelNode];
+        XCTAssertTrue(CGRectIntersectsRect(rect, aheadRect), @"Prefetched %@, which is not ahead of the scroll.", modelNode.name);
+        XCTAssertFalse(CGRectIntersectsRect(rect, visibleRect), @"Prefetched %@, which was already in view.", modelNode.name);
+    }
+}
+
+- (void)testCancelsNodesLeavingPrefetchWindow
+{
+    [self scrollBy:100.0f];
+    NSSet *prefetchedModelNodes = [aDelegate.prefetchedModelNodes copy];
+    [aDelegate reset];
+
+    // Far enough that everything prefetched so far is behind the scroll.
+    [self scrollBy:500.0f];
+    CGRect visibleRect = [self visibleRect];
+    CGRect prefetchRect = CGRectUnion(visibleRect, CGRectOffset(visibleRect, 0.0f, visibleRect.size.height));
+
+    XCTAssertTrue(aDelegate.cancelledModelNodes.count > 0, @"Expected nodes left behind to be cancelled.");
+    for (TestModelNode *modelNode in aDelegate.cancelledModelNodes) {
+        XCTAssertTrue([prefetchedModelNodes containsObject:modelNode], @"Cancelled %@, which was never prefetched.", modelNode.name);
+        XCTAssertFalse(CGRectIntersectsRect([self rectOfModelNode:modelNode], prefetchRect),
+                       @"Cancelled %@, which is still in the prefetch window.", modelNode.name);
+    }
+    XCTAssertFalse([aDelegate.prefetchedModelNodes intersectsSet:aDelegate.cancelledModelNodes]);
+}
+
+@end
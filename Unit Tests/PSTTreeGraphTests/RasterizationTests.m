@@ -0,0 +1,152 @@
+//
+//  RasterizationTests.m
+//  PSTTreeGraphTests
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+
+#import "RasterizationTests.h"
+
+#import "PSBaseTreeGraphView_Internal.h"
+#import "PSBaseSubtreeView.h"
+
+#import "TestModelNode.h"
+#import "TestNodeViewNib.h"
+
+
+@implementation RasterizationTests
+
+- (void)setUp
+{
+    [super setUp];
+
+    // Set-up code here.
+
+    // The whole tree, and each child of the root, is larger than the scroll view.  The subtrees
+    // one level further down fit.
+    model = [TestModelNode treeWithDepth:4 breadth:3];
+
+    aScrollView = [[UIScrollView alloc] initWithFrame:CGRectMake(0.0f, 0.0f, 400.0f, 300.0f)];
+    aTreeGraph = [[PSBaseTreeGraphView alloc] initWithFrame:aScrollView.bounds];
+    [aScrollView addSubview:aTreeGraph];
+
+    [TestNodeViewNib installInTreeGraph:aTreeGraph nodeSize:CGSizeMake(100.0f, 30.0f)];
+    aTreeGraph.minimumRasterizedSubtreeArea = 1.0f;
+    aTreeGraph.modelRoot = model;
+    aScrollView.contentSize = aTreeGraph.frame.size;
+
+    aTreeGraph.rasterizesStableSubtrees = YES;
+}
+
+- (void)tearDown
+{
+    // Tear-down code here.
+
+    [super tearDown];
+}
+
+- (CGRect) visibleRect
+{
+    return [aTreeGraph convertRect:aScrollView.bounds fromView:aScrollView];
+}
+
+- (void) collectRasterizedSubtreeViewsOfView:(UIView *)view into:(NSMutableArray *)subtreeViews
+{
+    if ([view isKindOfClass:[PSBaseSubtreeView class]] && view.layer.shouldRasterize) {
+        [subtreeViews addObject:view];
+    }
+    for (UIView *subview in view.subviews) {
+        [self collectRasterizedSubtreeViewsOfView:subview into:subtreeViews];
+    }
+}
+
+- (NSArray *) rasterizedSubtreeViews
+{
+    NSMutableArray *subtreeViews = [NSMutableArray array];
+    [self collectRasterizedSubtreeViewsOfView:aTreeGraph into:subtreeViews];
+    return subtreeViews;
+}
+
+- (void) scrollTo:(CGPoint)contentOffset
+{
+    aScrollView.contentOffset = contentOffset;
+    [aTreeGraph parentClipViewDidScroll:aScrollView];
+}
+
+
+#pragma mark - Choosing Subtrees
+
+- (void)testNeverChoosesSubtreeLargerThanVisibleRect
+{
+    CGSize visibleSize = [self visibleRect].size;
+
+    NSArray *subtreeViews = [self rasterizedSubtreeViews];
+    XCTAssertTrue(subtreeViews.count > 0, @"Expected some subtrees to be flattened.");
+    XCTAssertEqual(subtreeViews.count, aTreeGraph.rasterizedSubtreeCount);
+
+    for (PSBaseSubtreeView *subtreeView in subtreeViews) {
+        XCTAssertTrue(subtreeView.frame.size.width <= visibleSize.width && subtreeView.frame.size.height <= visibleSize.height,
+                      @"Flattened %@, which is larger than the visible rect.", subtreeView.modelNode);
+    }
+    XCTAssertFalse(aTreeGraph.rootSubtreeView.layer.shouldRasterize);
+}
+
+- (void)testBudgetLimitsChoice
+{
+    aTreeGraph.rasterizationCacheBudget = 0;
+
+    XCTAssertEqual(aTreeGraph.rasterizedSubtreeCount, (NSUInteger)0);
+    XCTAssertEqual(aTreeGraph.rasterizationCacheSize, (NSUInteger)0);
+    XCTAssertEqual([self rasterizedSubtreeViews].count, (NSUInteger)0);
+}
+
+- (void)testSelectedSubtreeStaysLive
+{
+    NSArray *subtreeViews = [self rasterizedSubtreeViews];
+    XCTAssertTrue(subtreeViews.count > 0, @"Expected some subtrees to be flattened.");
+
+    PSBaseSubtreeView *subtreeView = subtreeViews.firstObject;
+    TestModelNode *leaf = (TestModelNode *)[subtreeView.modelNode childModelNodes].firstObject;
+    aTreeGraph.selectedModelNodes = [NSSet setWithObject:leaf];
+    [aTreeGraph parentClipViewDidScroll:aScrollView];
+
+    XCTAssertFalse(subtreeView.layer.shouldRasterize, @"A subtree holding the selection was left flattened.");
+}
+
+
+#pragma mark - Hit Rate
+
+- (void)testHitRateCountsSubtreesSurvivingLayout
+{
+    NSUInteger rasterizedCount = aTreeGraph.rasterizedSubtreeCount;
+    XCTAssertTrue(rasterizedCount > 1, @"Expected several subtrees to be flattened.");
+
+    // Relayout one flattened subtree, without moving anything.  Only that one is rendered anew.
+    PSBaseSubtreeView *relaidSubtreeView = [self rasterizedSubtreeViews].firstObject;
+    PSBaseSubtreeView *leafSubtreeView = [aTreeGraph subtreeViewForModelNode:[relaidSubtreeView.modelNode childModelNodes].lastObject];
+
+    [aTreeGraph resetRasterizationStatistics];
+    [leafSubtreeView setNeedsGraphLayoutIncludingAncestors];
+    [aTreeGraph layoutGraphIfNeeded];
+
+    XCTAssertEqual(aTreeGraph.rasterizedSubtreeCount, rasterizedCount);
+    XCTAssertEqualWithAccuracy(aTreeGraph.rasterizationCacheHitRate,
+                               (CGFloat)(rasterizedCount - 1) / (CGFloat)rasterizedCount, 0.0001);
+}
+
+- (void)testScrollingDoesNotCountTowardsHitRate
+{
+    [aTreeGraph resetRasterizationStatistics];
+
+    // Every subtree still chosen after a scroll keeps its bitmap, so counting scrolls would make
+    // the hit rate non-zero.
+    [self scrollTo:CGPointMake(0.0f, 40.0f)];
+    [self scrollTo:CGPointMake(0.0f, 80.0f)];
+    [self scrollTo:CGPointZero];
+
+    XCTAssertTrue(aTreeGraph.rasterizedSubtreeCount > 0, @"Expected some subtrees to be flattened.");
+    XCTAssertEqual(aTreeGraph.rasterizationCacheHitRate, (CGFloat)0.0);
+}
+
+@end
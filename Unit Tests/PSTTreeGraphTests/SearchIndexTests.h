@@ -0,0 +1,21 @@
+//
+//  SearchIndexTests.h
+//  PSTTreeGraphTests
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "PSTreeGraphSearchIndex.h"
+
+@class TestModelNode;
+
+@interface SearchIndexTests : XCTestCase
+{
+    TestModelNode* model;
+    PSTreeGraphSearchIndex* searchIndex;
+}
+
+@end
@@ -0,0 +1,162 @@
+//
+//  SearchIndexTests.m
+//  PSTTreeGraphTests
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+
+#import "SearchIndexTests.h"
+
+#import "TestModelNode.h"
+
+
+@implementation SearchIndexTests
+
+- (void)setUp
+{
+    [super setUp];
+
+    // Set-up code here.
+
+    // Tree order:  Animals 0, Big Cat 1, Cat 2, Lion 3, Catalog 4, Catfish 5, Éclair 6.
+    // Catalog is shared by Big Cat and Catfish.
+
+    model = [TestModelNode nodeWithName:@"Animals"];
+    TestModelNode *bigCat = [TestModelNode nodeWithName:@"Big Cat"];
+    TestModelNode *catfish = [TestModelNode nodeWithName:@"Catfish"];
+    TestModelNode *catalog = [TestModelNode nodeWithName:@"Catalog"];
+    [model addChild:bigCat];
+    [model addChild:catfish];
+    [bigCat addChild:[TestModelNode nodeWithName:@"Cat"]];
+    [bigCat addChild:[TestModelNode nodeWithName:@"Lion"]];
+    [bigCat addChild:catalog];
+    [catfish addChild:catalog];
+    [catfish addChild:[TestModelNode nodeWithName:@"Éclair"]];
+
+    searchIndex = [[PSTreeGraphSearchIndex alloc] initWithModelRoot:model
+                                                       labelProvider:^NSString *(id <PSTreeGraphModelNode> modelNode) {
+        return ((TestModelNode *)modelNode).name;
+    }];
+    XCTAssertNotNil(searchIndex, @"Couldn't create search index.");
+}
+
+- (void)tearDown
+{
+    // Tear-down code here.
+
+    [super tearDown];
+}
+
+- (NSRange) rangeForSearchString:(NSString *)searchString
+{
+    return [searchIndex rangeOfEntriesWithPrefix:[PSTreeGraphSearchIndex normalizedString:searchString]
+                                         inRange:searchIndex.fullRange];
+}
+
+- (NSArray *) namesOfModelNodes:(NSArray *)modelNodes
+{
+    return [modelNodes valueForKey:@"name"];
+}
+
+
+#pragma mark - Prefix Search
+
+- (void)testPrefixMatchesLabelsAndWordsInTreeOrder
+{
+    NSArray *names = [self namesOfModelNodes:[searchIndex modelNodesInRange:[self rangeForSearchString:@"CAT"]]];
+
+    // Big Cat matches on its second word.  Catalog is reachable twice, but listed once.
+    NSArray *expected = @[ @"Big Cat", @"Cat", @"Catalog", @"Catfish" ];
+    XCTAssertEqualObjects(names, expected);
+}
+
+- (void)testPrefixIgnoresDiacritics
+{
+    NSArray *names = [self namesOfModelNodes:[searchIndex modelNodesInRange:[self rangeForSearchString:@"ecl"]]];
+    XCTAssertEqualObjects(names, @[ @"Éclair" ]);
+}
+
+- (void)testPrefixAcrossWordBreak
+{
+    NSArray *names = [self namesOfModelNodes:[searchIndex modelNodesInRange:[self rangeForSearchString:@"big c"]]];
+    XCTAssertEqualObjects(names, @[ @"Big Cat" ]);
+}
+
+- (void)testNarrowingWithinPreviousRange
+{
+    NSRange range = [self rangeForSearchString:@"c"];
+    NSRange narrowed = [searchIndex rangeOfEntriesWithPrefix:@"cat" inRange:range];
+
+    XCTAssertTrue(NSEqualRanges(narrowed, [self rangeForSearchString:@"cat"]),
+                  @"Narrowing within a range should give the same range as a full search.");
+    XCTAssertTrue(NSLocationInRange(narrowed.location, range) && NSMaxRange(narrowed) <= NSMaxRange(range));
+
+    NSRange none = [searchIndex rangeOfEntriesWithPrefix:@"catz" inRange:narrowed];
+    XCTAssertEqual(none.length, (NSUInteger)0);
+}
+
+- (void)testEmptyPrefixMatchesWholeRange
+{
+    XCTAssertTrue(NSEqualRanges([searchIndex rangeOfEntriesWithPrefix:@"" inRange:searchIndex.fullRange],
+                                searchIndex.fullRange));
+}
+
+
+#pragma mark - Stepping Through Matches
+
+- (void)testFollowingStepsForwardInTreeOrder
+{
+    NSRange range = [self rangeForSearchString:@"cat"];
+
+    XCTAssertEqual([searchIndex treeOrderOfModelNodeInRange:range following:NSNotFound], (NSUInteger)1);
+    XCTAssertEqual([searchIndex treeOrderOfModelNodeInRange:range following:1], (NSUInteger)2);
+    XCTAssertEqual([searchIndex treeOrderOfModelNodeInRange:range following:2], (NSUInteger)4);
+    XCTAssertEqual([searchIndex treeOrderOfModelNodeInRange:range following:3], (NSUInteger)4);
+
+    // There is nothing after the last match.  Callers wrap by starting again from NSNotFound.
+    XCTAssertEqual([searchIndex treeOrderOfModelNodeInRange:range following:5], (NSUInteger)NSNotFound);
+}
+
+- (void)testPrecedingStepsBackwardInTreeOrder
+{
+    NSRange range = [self rangeForSearchString:@"cat"];
+
+    XCTAssertEqual([searchIndex treeOrderOfModelNodeInRange:range preceding:NSNotFound], (NSUInteger)5);
+    XCTAssertEqual([searchIndex treeOrderOfModelNodeInRange:range preceding:5], (NSUInteger)4);
+    XCTAssertEqual([searchIndex treeOrderOfModelNodeInRange:range preceding:4], (NSUInteger)2);
+    XCTAssertEqual([searchIndex treeOrderOfModelNodeInRange:range preceding:1], (NSUInteger)NSNotFound);
+}
+
+- (void)testTreeOrderMapsBackToModelNode
+{
+    NSRange range = [self rangeForSearchString:@"lion"];
+    NSUInteger treeOrder = [searchIndex treeOrderOfModelNodeInRange:range following:NSNotFound];
+
+    XCTAssertEqual(treeOrder, (NSUInteger)3);
+    XCTAssertEqualObjects([searchIndex modelNodeAtTreeOrder:treeOrder], [model nodeNamed:@"Lion"]);
+}
+
+- (void)testEmptyRangeHasNoMatches
+{
+    NSRange range = [self rangeForSearchString:@"zebra"];
+
+    XCTAssertEqual(range.length, (NSUInteger)0);
+    XCTAssertEqual([searchIndex modelNodesInRange:range].count, (NSUInteger)0);
+    XCTAssertEqual([searchIndex treeOrderOfModelNodeInRange:range following:NSNotFound], (NSUInteger)NSNotFound);
+    XCTAssertEqual([searchIndex treeOrderOfModelNodeInRange:range preceding:NSNotFound], (NSUInteger)NSNotFound);
+}
+
+
+#pragma mark - Matching Single Nodes
+
+- (void)testModelNodeMatchesPrefix
+{
+    XCTAssertTrue([searchIndex modelNode:[model nodeNamed:@"Big Cat"] matchesPrefix:@"cat"]);
+    XCTAssertTrue([searchIndex modelNode:[model nodeNamed:@"Big Cat"] matchesPrefix:@"big"]);
+    XCTAssertTrue([searchIndex modelNode:[model nodeNamed:@"Éclair"] matchesPrefix:@"eclair"]);
+    XCTAssertFalse([searchIndex modelNode:[model nodeNamed:@"Lion"] matchesPrefix:@"cat"]);
+    XCTAssertFalse([searchIndex modelNode:[model nodeNamed:@"Big Cat"] matchesPrefix:@"at"]);
+}
+
+@end
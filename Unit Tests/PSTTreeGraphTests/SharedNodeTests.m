@@ -0,0 +1,171 @@
+//
+//  SharedNodeTests.m
+//  PSTTreeGraphTests
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+
+#import "SharedNodeTests.h"
+
+#import <QuartzCore/QuartzCore.h>
+
+#import "PSBaseTreeGraphView_Internal.h"
+#import "PSBaseSubtreeView.h"
+
+#import "TestModelNode.h"
+#import "TestNodeViewNib.h"
+
+
+@implementation SharedNodeTests
+
+- (void)setUp
+{
+    [super setUp];
+
+    // Set-up code here.
+
+    // root has children a and b.  shared is a child of both, and b's only child.  a also has a leaf.
+
+    model = [TestModelNode nodeWithName:@"root"];
+    TestModelNode *a = [TestModelNode nodeWithName:@"a"];
+    TestModelNode *b = [TestModelNode nodeWithName:@"b"];
+    TestModelNode *shared = [TestModelNode nodeWithName:@"shared"];
+    [model addChild:a];
+    [model addChild:b];
+    [a addChild:shared];
+    [a addChild:[TestModelNode nodeWithName:@"leaf"]];
+    [b addChild:shared];
+
+    aTreeGraph = [[PSBaseTreeGraphView alloc] initWithFrame:CGRectMake(0.0f, 0.0f, 1024.0f, 768.0f)];
+    [TestNodeViewNib installInTreeGraph:aTreeGraph nodeSize:CGSizeMake(100.0f, 30.0f)];
+}
+
+- (void)tearDown
+{
+    // Tear-down code here.
+
+    [super tearDown];
+}
+
+- (PSBaseSubtreeView *) subtreeViewNamed:(NSString *)name
+{
+    return [aTreeGraph subtreeViewForModelNode:[model nodeNamed:name]];
+}
+
+- (NSUInteger) countOfSubtreeViewsInView:(UIView *)view
+{
+    NSUInteger count = [view isKindOfClass:[PSBaseSubtreeView class]] ? 1 : 0;
+    for (UIView *subview in view.subviews) {
+        count += [self countOfSubtreeViewsInView:subview];
+    }
+    return count;
+}
+
+- (CGPathRef) crossEdgePath
+{
+    // Cross-edges are drawn by the one shape layer the TreeGraph adds to its own layer.
+    for (CALayer *layer in aTreeGraph.layer.sublayers) {
+        if ([layer isKindOfClass:[CAShapeLayer class]]) {
+            return ((CAShapeLayer *)layer).path;
+        }
+    }
+    return NULL;
+}
+
+
+#pragma mark - Shared Nodes
+
+- (void)testSharedChildBuildsOneSubtreeView
+{
+    aTreeGraph.modelRoot = model;
+
+    XCTAssertEqual([self countOfSubtreeViewsInView:aTreeGraph], (NSUInteger)5, @"Expected one SubtreeView per distinct node.");
+    XCTAssertEqual([self subtreeViewNamed:@"shared"].superview, [self subtreeViewNamed:@"a"],
+                   @"A shared node should be laid out under the first parent that reaches it.");
+}
+
+- (void)testSharedChildIsLaidOutUnderFirstParent
+{
+    aTreeGraph.modelRoot = model;
+
+    TestModelNode *shared = [model nodeNamed:@"shared"];
+    XCTAssertEqualObjects([aTreeGraph layoutParentOfModelNode:shared], [model nodeNamed:@"a"]);
+    XCTAssertTrue([aTreeGraph modelNode:shared isDescendantOf:[model nodeNamed:@"a"]]);
+    XCTAssertFalse([aTreeGraph modelNode:shared isDescendantOf:[model nodeNamed:@"b"]]);
+}
+
+- (void)testSharedChildIsJoinedByCrossEdge
+{
+    aTreeGraph.modelRoot = model;
+    XCTAssertTrue([self crossEdgePath] != NULL, @"The second parent wasn't joined to the shared node.");
+
+    aTreeGraph.modelRoot = [TestModelNode treeWithDepth:3 breadth:2];
+    XCTAssertTrue([self crossEdgePath] == NULL, @"A tree without shared nodes has no cross-edges.");
+}
+
+- (void)testCycleIsBuiltOnce
+{
+    // A child that lists the root as its own child must not recurse forever.
+    [[model nodeNamed:@"leaf"] addChild:model];
+    aTreeGraph.modelRoot = model;
+
+    XCTAssertEqual([self countOfSubtreeViewsInView:aTreeGraph], (NSUInteger)5);
+    XCTAssertTrue([self crossEdgePath] != NULL);
+}
+
+- (void)testIsLeafCountsOnlyOwnedChildren
+{
+    aTreeGraph.modelRoot = model;
+
+    XCTAssertFalse([self subtreeViewNamed:@"a"].leaf);
+    XCTAssertTrue([self subtreeViewNamed:@"leaf"].leaf);
+
+    // b's only child is drawn under a, so b has nothing of its own to expand or collapse.
+    XCTAssertTrue([self subtreeViewNamed:@"b"].leaf);
+}
+
+
+#pragma mark - Forests
+
+- (void)testForestRootsShareAnEmptyRoot
+{
+    TestModelNode *other = [TestModelNode treeWithDepth:2 breadth:2];
+    other.name = @"other";
+    other.identifier = @"other";
+    aTreeGraph.modelRoots = @[ model, other ];
+
+    PSBaseSubtreeView *rootSubtreeView = aTreeGraph.rootSubtreeView;
+    XCTAssertTrue(rootSubtreeView.forestRoot);
+    XCTAssertTrue(rootSubtreeView.nodeView.hidden, @"A forest's root should have no visible node.");
+
+    XCTAssertEqual([aTreeGraph subtreeViewForModelNode:model].superview, rootSubtreeView);
+    XCTAssertEqual([aTreeGraph subtreeViewForModelNode:other].superview, rootSubtreeView);
+
+    XCTAssertEqualObjects(aTreeGraph.selectableRootModelNode, model, @"The first root should be selected to start with.");
+    XCTAssertEqualObjects(aTreeGraph.modelRoots, (@[ model, other ]), @"Roots should keep their order.");
+
+    // Roots are laid out like the children of one node, in order.
+    NSMutableArray *rootSubtreeViews = [NSMutableArray array];
+    for (UIView *subview in rootSubtreeView.subviews) {
+        if ([subview isKindOfClass:[PSBaseSubtreeView class]]) {
+            [rootSubtreeViews addObject:subview];
+        }
+    }
+    XCTAssertEqualObjects([rootSubtreeViews valueForKey:@"modelNode"], (@[ model, other ]));
+    XCTAssertNil([aTreeGraph layoutParentOfModelNode:model]);
+}
+
+- (void)testForestIdentifierNeedsEveryRootIdentifier
+{
+    TestModelNode *other = [TestModelNode treeWithDepth:2 breadth:2];
+    other.name = @"other";
+    other.identifier = @"other";
+    aTreeGraph.modelRoots = @[ model, other ];
+    XCTAssertNotNil([aTreeGraph.modelRoot modelNodeIdentifier]);
+
+    other.identifier = nil;
+    XCTAssertNil([aTreeGraph.modelRoot modelNodeIdentifier], @"A forest with an anonymous root can't be identified.");
+}
+
+@end
@@ -0,0 +1,22 @@
+//
+//  StyleUpdateTests.h
+//  PSTTreeGraphTests
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "PSBaseTreeGraphView.h"
+
+@class TestModelNode;
+
+@interface StyleUpdateTests : XCTestCase
+{
+    TestModelNode* model;
+    UIScrollView* aScrollView;
+    PSBaseTreeGraphView* aTreeGraph;
+}
+
+@end
@@ -0,0 +1,143 @@
+//
+//  StyleUpdateTests.m
+//  PSTTreeGraphTests
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+
+#import "StyleUpdateTests.h"
+
+#import "PSBaseTreeGraphView_Internal.h"
+#import "PSBaseSubtreeView.h"
+
+#import "TestModelNode.h"
+#import "TestNodeViewNib.h"
+
+
+@implementation StyleUpdateTests
+
+- (void)setUp
+{
+    [super setUp];
+
+    // Set-up code here.
+
+    // Much larger than the scroll view, so most subtrees start out of sight.
+    model = [TestModelNode treeWithDepth:4 breadth:3];
+
+    aScrollView = [[UIScrollView alloc] initWithFrame:CGRectMake(0.0f, 0.0f, 400.0f, 300.0f)];
+    aTreeGraph = [[PSBaseTreeGraphView alloc] initWithFrame:aScrollView.bounds];
+    [aScrollView addSubview:aTreeGraph];
+
+    [TestNodeViewNib installInTreeGraph:aTreeGraph nodeSize:CGSizeMake(100.0f, 30.0f)];
+    aTreeGraph.modelRoot = model;
+    aScrollView.contentSize = aTreeGraph.frame.size;
+}
+
+- (void)tearDown
+{
+    // Tear-down code here.
+
+    [super tearDown];
+}
+
+- (void) collectModelNodesOf:(TestModelNode *)modelNode into:(NSMutableArray *)modelNodes
+{
+    [modelNodes addObject:modelNode];
+    for (TestModelNode *child in modelNode.children) {
+        [self collectModelNodesOf:child into:modelNodes];
+    }
+}
+
+- (NSArray *) allModelNodes
+{
+    NSMutableArray *modelNodes = [NSMutableArray array];
+    [self collectModelNodesOf:model into:modelNodes];
+    return modelNodes;
+}
+
+- (BOOL) subtreeViewIsVisible:(PSBaseSubtreeView *)subtreeView
+{
+    CGRect visibleRect = [aTreeGraph convertRect:aScrollView.bounds fromView:aScrollView];
+    CGRect frame = [aTreeGraph convertRect:subtreeView.bounds fromView:subtreeView];
+    return CGRectIntersectsRect(frame, visibleRect);
+}
+
+- (BOOL) subtreeViewShowsFrame:(PSBaseSubtreeView *)subtreeView
+{
+    return subtreeView.layer.borderWidth > 0.0f;
+}
+
+- (void) assertOnlyVisibleSubtreesShowFrames
+{
+    NSUInteger staleCount = 0;
+    for (TestModelNode *modelNode in [self allModelNodes]) {
+        PSBaseSubtreeView *subtreeView = [aTreeGraph subtreeViewForModelNode:modelNode];
+        if ( [self subtreeViewIsVisible:subtreeView] ) {
+            XCTAssertTrue([self subtreeViewShowsFrame:subtreeView], @"Visible subtree %@ was not updated.", modelNode.name);
+        } else {
+            XCTAssertFalse([self subtreeViewShowsFrame:subtreeView], @"Subtree %@ was updated out of sight.", modelNode.name);
+            ++staleCount;
+        }
+    }
+    XCTAssertTrue(staleCount > 0, @"Expected some subtrees to be out of sight.");
+}
+
+
+#pragma mark - Batching
+
+- (void)testBatchedStyleChangesMakeOnePass
+{
+    NSUInteger passCount = aTreeGraph.styleUpdatePassCount;
+
+    [aTreeGraph performStyleUpdates:^{
+        aTreeGraph.connectingLineColor = [UIColor redColor];
+        aTreeGraph.connectingLineWidth = 3.0f;
+        aTreeGraph.connectingLineStyle = PSTreeGraphConnectingLineStyleOrthogonal;
+        aTreeGraph.showsSubtreeFrames = YES;
+    }];
+    XCTAssertEqual(aTreeGraph.styleUpdatePassCount, passCount + 1);
+
+    // Nothing is left for the relayout the batch asked for.
+    [aTreeGraph layoutIfNeeded];
+    XCTAssertEqual(aTreeGraph.styleUpdatePassCount, passCount + 1);
+}
+
+- (void)testUnbatchedStyleChangesCoalesceUntilLayout
+{
+    NSUInteger passCount = aTreeGraph.styleUpdatePassCount;
+
+    aTreeGraph.connectingLineColor = [UIColor redColor];
+    aTreeGraph.showsSubtreeFrames = YES;
+    XCTAssertEqual(aTreeGraph.styleUpdatePassCount, passCount);
+
+    [aTreeGraph layoutIfNeeded];
+    XCTAssertEqual(aTreeGraph.styleUpdatePassCount, passCount + 1);
+}
+
+
+#pragma mark - Stale Subtrees
+
+- (void)testOffscreenSubtreesStayStaleUntilScrolledIntoView
+{
+    [aTreeGraph performStyleUpdates:^{
+        aTreeGraph.showsSubtreeFrames = YES;
+    }];
+
+    [self assertOnlyVisibleSubtreesShowFrames];
+
+    // Scrolling a stale leaf into view catches it up.  Those still out of sight stay stale.
+    PSBaseSubtreeView *staleSubtreeView = [aTreeGraph subtreeViewForModelNode:[model nodeNamed:@"root.0.0.0"]];
+    XCTAssertFalse([self subtreeViewIsVisible:staleSubtreeView], @"Expected the leaf to start out of sight.");
+
+    CGRect frame = [aTreeGraph convertRect:staleSubtreeView.bounds fromView:staleSubtreeView];
+    aScrollView.contentOffset = [aScrollView convertPoint:frame.origin fromView:aTreeGraph];
+    [aTreeGraph parentClipViewDidScroll:aScrollView];
+
+    XCTAssertTrue([self subtreeViewIsVisible:staleSubtreeView]);
+    XCTAssertTrue([self subtreeViewShowsFrame:staleSubtreeView]);
+    [self assertOnlyVisibleSubtreesShowFrames];
+}
+
+@end
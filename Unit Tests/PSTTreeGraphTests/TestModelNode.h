@@ -0,0 +1,40 @@
+//
+//  TestModelNode.h
+//  PSTTreeGraphTests
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "PSTreeGraphModelNode.h"
+
+// A minimal model node for tests.  A node may be added as the child of several parents, to
+// build graphs with shared nodes.  Its parentModelNode is the first parent it was added to.
+
+@interface TestModelNode : NSObject <PSTreeGraphModelNode>
+
++ (instancetype) nodeWithName:(NSString *)name;
+
+// Returns a complete tree of the given depth (1 is a lone root), where every interior node has
+// breadth children.  Nodes are named by their path from the root, ie. "root", "root.0", "root.0.1".
+
++ (instancetype) treeWithDepth:(NSUInteger)depth breadth:(NSUInteger)breadth;
+
+@property (nonatomic, copy) NSString *name;
+
+// Returned by -modelNodeIdentifier.  Defaults to the name.
+
+@property (nonatomic, copy) NSString *identifier;
+
+@property (nonatomic, weak, readonly) TestModelNode *parent;
+@property (nonatomic, readonly) NSArray *children;
+
+- (void) addChild:(TestModelNode *)child;
+
+// Returns the descendant (or self) with the given name, or nil.
+
+- (TestModelNode *) nodeNamed:(NSString *)name;
+
+@end
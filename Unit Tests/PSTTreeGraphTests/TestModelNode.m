@@ -0,0 +1,110 @@
+//
+//  TestModelNode.m
+//  PSTTreeGraphTests
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+
+#import "TestModelNode.h"
+
+@interface TestModelNode ()
+{
+@private
+    NSMutableArray *_children;
+}
+
+@property (nonatomic, weak, readwrite) TestModelNode *parent;
+
+@end
+
+
+@implementation TestModelNode
+
++ (instancetype) nodeWithName:(NSString *)name
+{
+    TestModelNode *node = [[self alloc] init];
+    node.name = name;
+    node.identifier = name;
+    return node;
+}
+
++ (void) addChildrenToNode:(TestModelNode *)node depth:(NSUInteger)depth breadth:(NSUInteger)breadth
+{
+    if (depth <= 1) {
+        return;
+    }
+    for (NSUInteger index = 0; index < breadth; ++index) {
+        TestModelNode *child = [self nodeWithName:[NSString stringWithFormat:@"%@.%lu", node.name, (unsigned long)index]];
+        [node addChild:child];
+        [self addChildrenToNode:child depth:depth - 1 breadth:breadth];
+    }
+}
+
++ (instancetype) treeWithDepth:(NSUInteger)depth breadth:(NSUInteger)breadth
+{
+    TestModelNode *root = [self nodeWithName:@"root"];
+    [self addChildrenToNode:root depth:depth breadth:breadth];
+    return root;
+}
+
+- (instancetype) init
+{
+    self = [super init];
+    if (self) {
+        _children = [[NSMutableArray alloc] init];
+    }
+    return self;
+}
+
+- (NSArray *) children
+{
+    return [_children copy];
+}
+
+- (void) addChild:(TestModelNode *)child
+{
+    if (child.parent == nil) {
+        child.parent = self;
+    }
+    [_children addObject:child];
+}
+
+- (TestModelNode *) nodeNamed:(NSString *)name
+{
+    if ([self.name isEqualToString:name]) {
+        return self;
+    }
+    for (TestModelNode *child in _children) {
+        TestModelNode *node = [child nodeNamed:name];
+        if (node) {
+            return node;
+        }
+    }
+    return nil;
+}
+
+- (NSString *) description
+{
+    return [NSString stringWithFormat:@"<%@ %@>", [self class], self.name];
+}
+
+
+#pragma mark - PSTreeGraphModelNode
+
+- (id <PSTreeGraphModelNode> ) parentModelNode
+{
+    return self.parent;
+}
+
+- (NSArray *) childModelNodes
+{
+    return self.children;
+}
+
+- (NSString *) modelNodeIdentifier
+{
+    return self.identifier;
+}
+
+@end
@@ -0,0 +1,27 @@
+//
+//  TestNodeViewNib.h
+//  PSTTreeGraphTests
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+
+#import <UIKit/UIKit.h>
+
+@class PSBaseTreeGraphView;
+
+// Stands in for a node view nib, so TreeGraphs can be built without one in the test host's bundle.
+// Each instantiation creates a LeafView of nodeSize, and makes it the owning SubtreeView's nodeView.
+
+@interface TestNodeViewNib : UINib
+
+- (instancetype) initWithNodeSize:(CGSize)nodeSize;
+
+@property (nonatomic, readonly) CGSize nodeSize;
+
+// Sets a nodeViewNibName on treeGraph, and a TestNodeViewNib of nodeSize as its cached nib.
+// Call before assigning a modelRoot.
+
++ (void) installInTreeGraph:(PSBaseTreeGraphView *)treeGraph nodeSize:(CGSize)nodeSize;
+
+@end
@@ -0,0 +1,44 @@
+//
+//  TestNodeViewNib.m
+//  PSTTreeGraphTests
+//
+//  Created by agent on 10/19/26.
+//  Copyright 2026 Preston Software. All rights reserved.
+//
+
+#import "TestNodeViewNib.h"
+
+#import "PSBaseTreeGraphView.h"
+#import "PSBaseTreeGraphView_Internal.h"
+#import "PSBaseSubtreeView.h"
+#import "PSBaseLeafView.h"
+
+
+@implementation TestNodeViewNib
+
+- (instancetype) initWithNodeSize:(CGSize)nodeSize
+{
+    self = [super init];
+    if (self) {
+        _nodeSize = nodeSize;
+    }
+    return self;
+}
+
++ (void) installInTreeGraph:(PSBaseTreeGraphView *)treeGraph nodeSize:(CGSize)nodeSize
+{
+    // Setting the name lets go of any cached nib, so it has to come first.
+    treeGraph.nodeViewNibName = @"TestNodeView";
+    treeGraph.cachedNodeViewNib = [[self alloc] initWithNodeSize:nodeSize];
+}
+
+- (NSArray *) instantiateWithOwner:(id)ownerOrNil options:(NSDictionary *)optionsOrNil
+{
+    PSBaseLeafView *nodeView = [[PSBaseLeafView alloc] initWithFrame:CGRectMake(0.0f, 0.0f, _nodeSize.width, _nodeSize.height)];
+    if ([ownerOrNil isKindOfClass:[PSBaseSubtreeView class]]) {
+        ((PSBaseSubtreeView *)ownerOrNil).nodeView = nodeView;
+    }
+    return @[ nodeView ];
+}
+
+@end